@@ -0,0 +1,108 @@
+//==============================================================================
+// Multithreaded stress test of the DRV_RING templates on the host build,
+// where the LDREX/STREX pair of MpscRing is the std::atomic compare-and-swap.
+// Small rings keep the producers and the consumer on the full/empty edges:
+//   SpscRing - one producer, one consumer, strict FIFO order
+//   MpscRing - RING_PRODUCERS producers, one consumer, per-producer FIFO
+//              order, no lost, duplicated or torn elements
+//==============================================================================
+#include "DRV_RING.h"
+#include <stdio.h>
+#include <thread>
+#include <vector>
+
+//------------------------------------------------------------------------------
+#define RING_ITEMS				2000000		// per producer
+#define RING_PRODUCERS			4
+
+static uint32_t Failures = 0;
+
+#define CHECK(Condition)												\
+	do{ if(!(Condition)){ printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #Condition); Failures++;}}while(0)
+
+// the check word exposes a torn (half-written) element
+struct RING_Item{
+	uint32_t Producer;
+	uint32_t Sequence;
+	uint32_t Check;
+};
+
+static inline RING_Item RING_MakeItem(uint32_t Producer, uint32_t Sequence){
+	return(RING_Item{Producer, Sequence, ~(Producer ^ (Sequence * 0x9E3779B1))});
+}
+
+static inline bool RING_IsValid(const RING_Item& Item){
+	return(Item.Check == ~(Item.Producer ^ (Item.Sequence * 0x9E3779B1)));
+}
+
+//------------------------------------------------------------------------------
+static SpscRing<RING_Item, 64> Spsc;
+
+static void TestSpsc(){
+	std::thread producer([](){
+		for(uint32_t i=0; i<RING_ITEMS; i++){
+			while(!Spsc.Push(RING_MakeItem(0, i))){ std::this_thread::yield();}
+		}
+	});
+
+	uint32_t expected = 0, torn = 0, reordered = 0;
+	RING_Item item;
+	while(expected < RING_ITEMS){
+		if(!Spsc.Pop(item)){ std::this_thread::yield(); continue;}
+		if(!RING_IsValid(item)){ torn++;}
+		if(item.Sequence != expected){ reordered++;}
+		expected = item.Sequence + 1;
+	}
+	producer.join();
+
+	CHECK(torn == 0);
+	CHECK(reordered == 0);
+	CHECK(Spsc.IsEmpty());
+	printf("  SpscRing: %u items, %u torn, %u out of order\n", RING_ITEMS, torn, reordered);
+}
+
+//------------------------------------------------------------------------------
+static MpscRing<RING_Item, 64> Mpsc;
+
+static void TestMpsc(){
+	std::vector<std::thread> producers;
+	for(uint32_t p=0; p<RING_PRODUCERS; p++){
+		producers.emplace_back([p](){
+			for(uint32_t i=0; i<RING_ITEMS; i++){
+				while(!Mpsc.Push(RING_MakeItem(p, i))){ std::this_thread::yield();}
+			}
+		});
+	}
+
+	uint32_t next[RING_PRODUCERS] = {};
+	uint32_t received = 0, torn = 0, reordered = 0;
+	RING_Item item;
+	while(received < (RING_ITEMS * RING_PRODUCERS)){
+		if(!Mpsc.Pop(item)){ std::this_thread::yield(); continue;}
+		received++;
+		if(!RING_IsValid(item) || (item.Producer >= RING_PRODUCERS)){ torn++; continue;}
+		if(item.Sequence != next[item.Producer]){ reordered++;}
+		next[item.Producer] = item.Sequence + 1;
+	}
+	for(std::thread& t : producers){ t.join();}
+
+	bool complete = true;
+	for(uint32_t p=0; p<RING_PRODUCERS; p++){ complete = complete && (next[p] == RING_ITEMS);}
+
+	CHECK(torn == 0);
+	CHECK(reordered == 0);
+	CHECK(complete);
+	CHECK(Mpsc.IsEmpty() && !Mpsc.Pop(item));
+	printf("  MpscRing: %u producers x %u items, %u torn, %u out of order\n",
+		RING_PRODUCERS, RING_ITEMS, torn, reordered);
+}
+
+//------------------------------------------------------------------------------
+int main(){
+	TestSpsc();
+	TestMpsc();
+	printf("RING_Stress: %s\n", Failures? "FAILED" : "passed");
+	return(Failures? 1 : 0);
+}
+
+//==============================================================================
@@ -0,0 +1,175 @@
+//==============================================================================
+#include "SSR_Host.h"
+#include "DRV_TMW.h"
+#include "DRV_REG.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+//------------------------------------------------------------------------------
+// simulated core registers (see Host/stm32f1xx.h)
+SCB_Type HostSCB;
+SysTick_Type HostSysTick;
+DWT_Type HostDWT;
+CoreDebug_Type HostCoreDebug;
+uint32_t HostIPSR = 0;
+uint32_t SystemCoreClock = SSR_HOST_CLOCK;
+
+static uint64_t HostMicroseconds = 0;
+static uint32_t HostExceptions = 0;
+static SSR_HostTimeoutHook HostTimeoutHook = NULL;
+static SSR_HostExceptionHook HostExceptionHook = SSR_HostPrintException;
+static uint32_t HostCallbacks[SSR_MAX_VECTORS];		// vector -> component (InstallCallback)
+static uint32_t HostBootVectors[SSR_MAX_VECTORS];	// what VTOR points to at reset (flash)
+
+//------------------------------------------------------------------------------
+static uint32_t SSR_HostCall(uint8_t Service, uint32_t a0 = 0, uint32_t a1 = 0, uint32_t a2 = 0, uint32_t a3 = 0){
+	uint32_t args[4] = {a0, a1, a2, a3};
+	return(SSR_Execute(Service, args));
+}
+
+// SysTick VAL counts down from LOAD within each millisecond
+static void SSR_HostUpdateSysTick(){
+	uint32_t load = SysTick->LOAD + 1;
+	uint32_t elapsed = (uint32_t)(HostMicroseconds % 1000);
+	SysTick->VAL = load - 1 - (uint32_t)(((uint64_t)elapsed * load) / 1000);
+}
+
+//------------------------------------------------------------------------------
+void SSR_HostInitialize(){
+	HostMicroseconds = 0;
+	HostExceptions = 0;
+	HostTimeoutHook = NULL;
+	HostExceptionHook = SSR_HostPrintException;
+	HostIPSR = 0;
+	for(uint32_t i=0; i<SSR_MAX_VECTORS; i++){ HostCallbacks[i] = 0;}
+
+	SystemCoreClock = SSR_HOST_CLOCK;
+	SysTick->LOAD = (SSR_HOST_CLOCK / 1000) - 1;
+	SCB->ICSR = 0;
+	SCB->VTOR = SSR_HostAddress(HostBootVectors);
+	DWT->CYCCNT = 0;
+	SSR_HostUpdateSysTick();
+
+	TMW_Initialize();
+	REG_Initialize();
+	SSR_PublishTime(0);
+}
+
+//------------------------------------------------------------------------------
+void SSR_HostAdvance(uint32_t Microseconds){
+	while(Microseconds){
+		uint32_t step = 1000 - (uint32_t)(HostMicroseconds % 1000);
+		if(step > Microseconds){ step = Microseconds;}
+		HostMicroseconds += step;
+		Microseconds -= step;
+		DWT->CYCCNT += (uint32_t)(((uint64_t)step * SystemCoreClock) / 1000000);
+		SSR_HostUpdateSysTick();
+
+		// millisecond boundary: what the kernel SysTick handler does on target
+		if((HostMicroseconds % 1000) == 0){
+			HostIPSR = SSR_VECTOR(SysTick_IRQn);
+			SSR_PublishTime((uint32_t)(HostMicroseconds / 1000));
+			TMW_Tick();
+			HostIPSR = 0;
+		}
+	}
+}
+
+//------------------------------------------------------------------------------
+uint64_t SSR_HostGetTime(){
+	return(HostMicroseconds);
+}
+
+void SSR_HostSetTimeoutHook(SSR_HostTimeoutHook Hook){
+	HostTimeoutHook = Hook;
+}
+
+void SSR_HostSetExceptionHook(SSR_HostExceptionHook Hook){
+	HostExceptionHook = Hook;
+}
+
+void SSR_HostPrintException(uint32_t Code){
+	fprintf(stderr, "SSR_ThrowException(0x%08X) at %llu us\n", Code, (unsigned long long)HostMicroseconds);
+}
+
+//------------------------------------------------------------------------------
+uint32_t SSR_HostAddress(const volatile void* Pointer){
+	uintptr_t address = (uintptr_t)Pointer;
+	if(address > 0xFFFFFFFF){
+		fprintf(stderr, "SSR_HostAddress(%p): above 4 GB, link with -no-pie and keep it static\n", (const void*)Pointer);
+		abort();
+	}
+	return((uint32_t)address);
+}
+
+uint32_t SSR_HostGetExceptions(){
+	return(HostExceptions);
+}
+
+//------------------------------------------------------------------------------
+// application side: direct calls instead of the "svc" stubs
+extern "C" {
+void SSR_IncludeComponent(uint32_t hComp){ SSR_HostCall(SVC_INCLUDE_COMPONENT, hComp);}
+void SSR_ExcludeComponent(uint32_t hComp){ SSR_HostCall(SVC_EXCLUDE_COMPONENT, hComp);}
+uint32_t SSR_InstallCallback(uint32_t a, uint32_t b){ return(SSR_HostCall(SVC_INSTALL_CALLBACK, a, b));}
+uint32_t SSR_GetCallback(uint32_t a){ return(SSR_HostCall(SVC_GET_CALLBACK, a));}
+bool SSR_InstallTimeout(uint32_t a, uint32_t b){ return(SSR_HostCall(SVC_INSTALL_TIMEOUT, a, b));}
+uint32_t SSR_GetCallbackVector(uint32_t a){ return(SSR_HostCall(SVC_GET_CALLBACK_VECTOR, a));}
+void SSR_ThrowMessage(uint32_t a, uint32_t b, uint32_t c, uint32_t d){ SSR_HostCall(SVC_THROW_MESSAGE, a, b, c, d);}
+void SSR_ThrowException(uint32_t a){ SSR_HostCall(SVC_THROW_EXCEPTION, a);}
+uint32_t SSR_Delay(uint32_t a){ return(SSR_HostCall(SVC_DELAY, a));}
+uint32_t SSR_MicroDelay(uint32_t a){ return(SSR_HostCall(SVC_MICRODELAY, a));}
+uint32_t SSR_Batch(SSR_Request* List, uint32_t N){ return(SSR_ExecuteBatch(List, N));}
+uint32_t SSR_ArmTimeout(uint32_t a, uint32_t b){ return(SSR_HostCall(SVC_ARM_TIMEOUT, a, b));}
+bool SSR_CancelTimeout(uint32_t a){ return(SSR_HostCall(SVC_CANCEL_TIMEOUT, a));}
+bool SSR_RescheduleTimeout(uint32_t a, uint32_t b){ return(SSR_HostCall(SVC_RESCHEDULE_TIMEOUT, a, b));}
+
+//------------------------------------------------------------------------------
+// kernel side: the services the target kernel implements
+uint32_t SSR_Service_RelocateVectors(uint32_t* Args){
+	SSR_Relocate((int)Args[0]);
+	return(0);
+}
+
+// InstallCallback(hComp, VectorIndex) routes a vector to a component
+uint32_t SSR_Service_InstallCallback(uint32_t* Args){
+	if(Args[1] >= SSR_MAX_VECTORS){ return(SSR_RESULT_INVALID);}
+	uint32_t result = HostCallbacks[Args[1]];
+	HostCallbacks[Args[1]] = Args[0];
+	return(result);
+}
+
+uint32_t SSR_Service_GetCallback(uint32_t* Args){
+	return((Args[0] < SSR_MAX_VECTORS)? HostCallbacks[Args[0]] : 0);
+}
+
+uint32_t SSR_Service_GetCallbackVector(uint32_t* Args){
+	for(uint32_t i=0; i<SSR_MAX_VECTORS; i++){
+		if((Args[0] != 0) && (HostCallbacks[i] == Args[0])){ return(i);}
+	}
+	return(SSR_RESULT_INVALID);
+}
+
+uint32_t SSR_Service_ThrowException(uint32_t* Args){
+	HostExceptions++;
+	if(HostExceptionHook != NULL){ HostExceptionHook(Args[0]);}
+	return(0);
+}
+
+// delays advance the simulated clock (timeouts expiring meanwhile do fire)
+uint32_t SSR_Service_Delay(uint32_t* Args){
+	SSR_HostAdvance(Args[0] * 1000);
+	return(0);
+}
+
+uint32_t SSR_Service_MicroDelay(uint32_t* Args){
+	SSR_HostAdvance(Args[0]);
+	return(0);
+}
+
+//------------------------------------------------------------------------------
+void SSR_NotifyTimeout(uint32_t hComp, uint32_t Handle){
+	if(HostTimeoutHook != NULL){ HostTimeoutHook(hComp, Handle);}
+}}
+
+//==============================================================================
@@ -0,0 +1,116 @@
+//==============================================================================
+/** @file SSR_Host.h
+ *  @brief Host (Linux) backend of the system service layer.
+ *  Runs the SSR_* services as direct calls through the same dispatch table
+ *  used on target (SSR_Execute), with a simulated SysTick clock, so that
+ *  components, timeouts and message lanes can be unit-tested and profiled
+ *  (perf, valgrind) without a board. Build with SSR_HOST defined and with
+ *  this directory ahead of the CMSIS headers in the include path.
+ *
+ *  Host/Makefile builds libssr_host.a, the tests and the benchmarks with a
+ *  stock 64-bit toolchain ("make -C Host test"). The services carry addresses
+ *  in 32-bit words, so everything is linked as a non-PIE executable (-no-pie),
+ *  which keeps code and static data below 4 GB: components, handlers and
+ *  requests passed to the services must be static (not on the stack or heap),
+ *  see SSR_HostAddress().
+ *  @version 1.0.0
+ *  @author J. Nilo Rodrigues - nilo@pobox.com
+ *
+ *------------------------------------------------------------------------------
+ *
+ * <h2><center>&copy; Copyright (c) 2020 Joao Nilo Rodrigues </center></h2>
+ * <h2><center> All rights reserved. </center></h2>
+ *
+ * This software component is licensed by "Joao Nilo Rodrigues" under BSD 3-Clause
+ * license, the "License".
+ * You may not use this file except in compliance with the License.
+ *               You may obtain a copy of the License at:
+ *                 opensource.org/licenses/BSD-3-Clause
+ *
+ *///---------------------------------------------------------------------------
+#ifndef SSR_HOST_H
+    #define SSR_HOST_H
+
+	#include "DRV_SSR.h"
+
+#ifndef SSR_HOST
+	#error "the host backend must be built with SSR_HOST defined"
+#endif
+
+//------------------------------------------------------------------------------
+/**
+ * @def SSR_HOST_CLOCK
+ * - simulated core clock (SysTick reload and DWT cycle counter follow it)
+ */
+#ifndef SSR_HOST_CLOCK
+	#define SSR_HOST_CLOCK				72000000
+#endif
+
+typedef void (*SSR_HostTimeoutHook)(uint32_t hComp, uint32_t Handle);
+typedef void (*SSR_HostExceptionHook)(uint32_t Code);
+
+/**
+ *  @defgroup SSR_HOST
+ *  @{
+ */
+
+//------------------------------------------------------------------------------
+/**
+ * @brief SSR_HostInitialize
+ * - Resets the simulated clock, the timing wheel, the registry and the hooks.
+ */
+void SSR_HostInitialize();
+
+/**
+ * @brief SSR_HostAdvance
+ * - Advances the simulated time. Every millisecond boundary crossed runs a
+ * SysTick: SSR_PublishTime() and TMW_Tick() (expired timeouts fire here).
+ * @arg Microseconds: the time to advance
+ */
+void SSR_HostAdvance(uint32_t Microseconds);
+
+/**
+ * @brief SSR_HostGetTime
+ * @return the simulated time, in microseconds since SSR_HostInitialize().
+ */
+uint64_t SSR_HostGetTime();
+
+/**
+ * @brief SSR_HostSetTimeoutHook
+ * - Receives the SSR_NotifyTimeout() calls (the kernel side on target).
+ */
+void SSR_HostSetTimeoutHook(SSR_HostTimeoutHook Hook);
+
+/**
+ * @brief SSR_HostSetExceptionHook
+ * - Receives the SSR_ThrowException() calls, after they are counted. The
+ * default hook is SSR_HostPrintException(); NULL only counts them.
+ */
+void SSR_HostSetExceptionHook(SSR_HostExceptionHook Hook);
+
+/**
+ * @brief SSR_HostPrintException
+ * - The default exception hook: prints the code and the time to stderr.
+ */
+void SSR_HostPrintException(uint32_t Code);
+
+/**
+ * @brief SSR_HostAddress
+ * - Converts a pointer to the 32-bit address the services carry.
+ * @arg Pointer: a static object (not on the stack or heap)
+ * @return the address; aborts if it does not fit in 32 bits.
+ */
+uint32_t SSR_HostAddress(const volatile void* Pointer);
+
+/**
+ * @brief SSR_HostGetExceptions
+ * @return the number of exceptions thrown since SSR_HostInitialize().
+ */
+uint32_t SSR_HostGetExceptions();
+
+/**
+ * @} // close group SSR_HOST
+ */
+
+#endif
+//==============================================================================
@@ -0,0 +1,176 @@
+//==============================================================================
+// Host test of the service layer: time, timeouts, messages, registry and
+// exceptions through the same SSR_* calls the application makes on target.
+//==============================================================================
+#include "SSR_Host.h"
+#include "DRV_MSG.h"
+#include "DRV_REG.h"
+#include "DRV_TMW.h"
+#include <stdio.h>
+
+//------------------------------------------------------------------------------
+static uint32_t Failures = 0;
+
+#define CHECK(Condition)												\
+	do{ if(!(Condition)){ printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #Condition); Failures++;}}while(0)
+
+static uint32_t Fired = 0;
+static uint32_t FiredComponent = 0;
+static uint32_t LastException = 0;
+
+static void OnTimeout(uint32_t hComp, uint32_t){
+	Fired++;
+	FiredComponent = hComp;
+}
+
+static void OnException(uint32_t Code){
+	LastException = Code;
+}
+
+// components are static: the services carry their address in 32 bits
+static uint32_t ComponentA, ComponentB;
+
+//------------------------------------------------------------------------------
+static void TestTime(){
+	SSR_HostInitialize();
+	SSR_HostAdvance(2500);
+	CHECK(SSR_GetSystemTime() == 2);
+	CHECK(SSR_Microseconds() == 2500);
+	SSR_Delay(3);
+	SSR_MicroDelay(250);
+	CHECK(SSR_HostGetTime() == 5750);
+	CHECK(SSR_GetSystemTime() == 5);
+}
+
+static void TestTimeouts(){
+	SSR_HostInitialize();
+	SSR_HostSetTimeoutHook(OnTimeout);
+	Fired = 0;
+
+	uint32_t a = SSR_HostAddress(&ComponentA);
+	uint32_t h = SSR_ArmTimeout(a, 5);
+	CHECK(h != 0);
+	SSR_HostAdvance(4000);
+	CHECK(Fired == 0);
+	SSR_HostAdvance(1000);
+	CHECK((Fired == 1) && (FiredComponent == a));
+
+	h = SSR_ArmTimeout(a, 10);
+	CHECK(SSR_CancelTimeout(h));
+	h = SSR_ArmTimeout(a, 2);
+	CHECK(SSR_RescheduleTimeout(h, 20));
+	SSR_HostAdvance(15000);
+	CHECK(Fired == 1);
+	SSR_HostAdvance(5000);
+	CHECK(Fired == 2);
+}
+
+// one timeout per component: installing again reschedules it
+static void TestInstallTimeout(){
+	SSR_HostInitialize();
+	SSR_HostSetTimeoutHook(OnTimeout);
+	Fired = 0;
+
+	uint32_t a = SSR_HostAddress(&ComponentA);
+	uint32_t b = SSR_HostAddress(&ComponentB);
+	for(uint32_t i=0; i<1000; i++){ CHECK(SSR_InstallTimeout(a, 10));}
+	CHECK(SSR_InstallTimeout(b, 5));
+	CHECK(TMW_GetArmed() == 2);
+	SSR_HostAdvance(5000);
+	CHECK((Fired == 1) && (FiredComponent == b));
+	CHECK(SSR_InstallTimeout(a, 20));
+	SSR_HostAdvance(10000);
+	CHECK(Fired == 1);
+	SSR_HostAdvance(10000);
+	CHECK((Fired == 2) && (FiredComponent == a) && (TMW_GetArmed() == 0));
+	CHECK(SSR_InstallTimeout(a, 1));
+	CHECK(TMW_GetArmed() == 1);
+
+	// cancelled through the component handle, ArmTimeout handles still work
+	CHECK(SSR_InstallTimeout(b, 5));
+	uint32_t h = SSR_ArmTimeout(b, 5);
+	CHECK(SSR_CancelTimeout(b) && !SSR_CancelTimeout(b));
+	CHECK(SSR_CancelTimeout(a) && (TMW_GetArmed() == 1));
+	CHECK(SSR_CancelTimeout(h) && (TMW_GetArmed() == 0));
+	SSR_HostAdvance(10000);
+	CHECK(Fired == 2);
+}
+
+// expiries are compared modulo 2^32
+static void TestTimerRange(){
+	SSR_HostInitialize();
+	CHECK(TMW_Arm(TMW_MAX_TICKS + 1, [](uint32_t, void*, uint32_t){}, NULL, 0) == TMW_INVALID);
+	uint32_t h = SSR_ArmTimeout(0, 5);
+	CHECK(!SSR_RescheduleTimeout(h, 0xFFFFFFFF) && SSR_RescheduleTimeout(h, TMW_MAX_TICKS));
+	CHECK(SSR_CancelTimeout(h));
+}
+
+static void TestMessages(){
+	SSR_HostInitialize();
+	NMESSAGE m;
+	while(MSG_Get(m)){}
+	SSR_ThrowMessage(1, 2, 3, 4);
+	CHECK(MSG_Get(m) && (m.message == 1) && (m.data1 == 2) && (m.tag == 4));
+	CHECK(!MSG_Get(m));
+}
+
+static void TestRegistry(){
+	SSR_HostInitialize();
+	uint32_t a = SSR_HostAddress(&ComponentA);
+	uint32_t b = SSR_HostAddress(&ComponentB);
+	SSR_IncludeComponent(a);
+	SSR_IncludeComponent(b);
+	CHECK(REG_Count() == 2);
+	CHECK(REG_Resolve(REG_Find(a)) == a);
+	SSR_ExcludeComponent(a);
+	CHECK(REG_Find(a) == REG_INVALID);
+	CHECK(REG_Resolve(REG_Find(b)) == b);
+
+	// handles from before a re-initialize are stale, even on the same slot
+	uint32_t hb = REG_Find(b);
+	REG_Initialize();
+	CHECK(REG_Resolve(hb) == 0);
+	CHECK((REG_Register(b) != hb) && (REG_Resolve(hb) == 0));
+
+	// excluding a component drops its installed timeout
+	CHECK(SSR_InstallTimeout(b, 5) && (TMW_GetArmed() == 1));
+	SSR_ExcludeComponent(b);
+	CHECK(TMW_GetArmed() == 0);
+}
+
+static void TestExceptions(){
+	SSR_HostInitialize();
+	SSR_HostSetExceptionHook(OnException);
+	SSR_ThrowException(7);
+	CHECK((SSR_HostGetExceptions() == 1) && (LastException == 7));
+	SSR_HostSetExceptionHook(NULL);
+	SSR_ThrowException(8);
+	CHECK((SSR_HostGetExceptions() == 2) && (LastException == 7));
+}
+
+static void Isr(void){}
+
+static void TestVectors(){
+	SSR_HostInitialize();
+	SSR_Relocate(0);
+	CHECK(SCB->VTOR == SSR_HostAddress(SSR_GetVectorTable()));
+	uint32_t isr = (uint32_t)(uintptr_t)Isr;
+	SSR_Allocate(isr, SSR_VECTOR(TIM2_IRQn));
+	CHECK(SSR_GetVectorTable()[SSR_VECTOR(TIM2_IRQn)] == isr);
+}
+
+//------------------------------------------------------------------------------
+int main(){
+	TestTime();
+	TestTimeouts();
+	TestInstallTimeout();
+	TestTimerRange();
+	TestMessages();
+	TestRegistry();
+	TestExceptions();
+	TestVectors();
+	printf("SSR_HostTest: %s\n", Failures? "FAILED" : "passed");
+	return(Failures? 1 : 0);
+}
+
+//==============================================================================
@@ -0,0 +1,136 @@
+//==============================================================================
+// Timing wheel benchmark: 10000 timers on DRV_TMW against a sorted linked
+// list (the usual "delta list" of small kernels), with the same workload:
+//   arm      - every timer armed with a pseudo-random 1 .. 60000 ms delay
+//   churn    - one random timer rescheduled per tick (watchdog-like use)
+//   expire   - ticks until every timer has fired
+// Both sides must fire the same timers on the same ticks (checksum).
+//==============================================================================
+#include "SSR_Host.h"
+#include "DRV_TMW.h"
+#include <stdio.h>
+#include <chrono>
+#include <list>
+
+//------------------------------------------------------------------------------
+#define BENCH_TIMERS			10000
+#define BENCH_MAX_DELAY			60000
+
+static_assert(__SYS_MAX_TIMERS >= BENCH_TIMERS, "build with -D__SYS_MAX_TIMERS >= BENCH_TIMERS (see Makefile)");
+
+typedef std::chrono::steady_clock BenchClock;
+
+static uint32_t Delays[BENCH_TIMERS];
+static uint32_t Churn[BENCH_MAX_DELAY + 1];		// timer rescheduled on each tick
+
+static uint32_t Random(uint32_t& Seed){
+	Seed = (Seed * 1664525) + 1013904223;
+	return(Seed >> 8);
+}
+
+static double Elapsed(BenchClock::time_point Start){
+	return(std::chrono::duration<double, std::nano>(BenchClock::now() - Start).count());
+}
+
+static void Report(const char* Name, const char* Phase, double Nanoseconds, uint32_t Operations){
+	printf("  %-12s %-7s %10.3f ms %9.1f ns/op\n", Name, Phase, Nanoseconds / 1e6, Nanoseconds / Operations);
+}
+
+//------------------------------------------------------------------------------
+// timing wheel
+static uint32_t WheelHandles[BENCH_TIMERS];
+static uint32_t WheelFired = 0;
+static uint64_t WheelSum = 0;
+
+static void WheelExpired(uint32_t, void*, uint32_t Data){
+	WheelFired++;
+	WheelSum += (uint64_t)(Data + 1) * TMW_GetTime();
+}
+
+static void BenchWheel(){
+	TMW_Initialize();
+
+	BenchClock::time_point start = BenchClock::now();
+	for(uint32_t i=0; i<BENCH_TIMERS; i++){ WheelHandles[i] = TMW_Arm(Delays[i], WheelExpired, NULL, i);}
+	Report("wheel", "arm", Elapsed(start), BENCH_TIMERS);
+
+	uint32_t ticks = 0;
+	start = BenchClock::now();
+	while(WheelFired < BENCH_TIMERS){
+		uint32_t i = Churn[ticks % (BENCH_MAX_DELAY + 1)];
+		if(ticks < BENCH_MAX_DELAY){ TMW_Reschedule(WheelHandles[i], Delays[i]);}
+		TMW_Tick();
+		ticks++;
+	}
+	Report("wheel", "run", Elapsed(start), ticks);
+}
+
+//------------------------------------------------------------------------------
+// sorted list baseline: O(n) insertion, O(1) expiry at the head
+struct ListTimer{
+	uint32_t Expiry;
+	uint32_t Index;
+};
+
+static std::list<ListTimer> ListTimers;
+static std::list<ListTimer>::iterator ListHandles[BENCH_TIMERS];
+static bool ListArmed[BENCH_TIMERS];
+static uint32_t ListNow = 0;
+static uint32_t ListFired = 0;
+static uint64_t ListSum = 0;
+
+static void ListArm(uint32_t Index, uint32_t Ticks){
+	uint32_t expiry = ListNow + Ticks;
+	std::list<ListTimer>::iterator it = ListTimers.begin();
+	while((it != ListTimers.end()) && (it->Expiry <= expiry)){ ++it;}
+	ListHandles[Index] = ListTimers.insert(it, ListTimer{expiry, Index});
+	ListArmed[Index] = true;
+}
+
+static void ListTick(){
+	ListNow++;
+	while(!ListTimers.empty() && (ListTimers.front().Expiry <= ListNow)){
+		uint32_t index = ListTimers.front().Index;
+		ListTimers.pop_front();
+		ListArmed[index] = false;
+		ListFired++;
+		ListSum += (uint64_t)(index + 1) * ListNow;
+	}
+}
+
+static void BenchList(){
+	BenchClock::time_point start = BenchClock::now();
+	for(uint32_t i=0; i<BENCH_TIMERS; i++){ ListArm(i, Delays[i]);}
+	Report("sorted list", "arm", Elapsed(start), BENCH_TIMERS);
+
+	uint32_t ticks = 0;
+	start = BenchClock::now();
+	while(ListFired < BENCH_TIMERS){
+		uint32_t i = Churn[ticks % (BENCH_MAX_DELAY + 1)];
+		if((ticks < BENCH_MAX_DELAY) && ListArmed[i]){
+			ListTimers.erase(ListHandles[i]);
+			ListArm(i, Delays[i]);
+		}
+		ListTick();
+		ticks++;
+	}
+	Report("sorted list", "run", Elapsed(start), ticks);
+}
+
+//------------------------------------------------------------------------------
+int main(){
+	uint32_t seed = 12345;
+	for(uint32_t i=0; i<BENCH_TIMERS; i++){ Delays[i] = 1 + (Random(seed) % BENCH_MAX_DELAY);}
+	for(uint32_t i=0; i<=BENCH_MAX_DELAY; i++){ Churn[i] = Random(seed) % BENCH_TIMERS;}
+
+	SSR_HostInitialize();
+	printf("TMW_Bench: %u timers, delays 1..%u ticks, one reschedule per tick\n", BENCH_TIMERS, BENCH_MAX_DELAY);
+	BenchWheel();
+	BenchList();
+
+	bool same = (WheelFired == ListFired) && (WheelSum == ListSum);
+	printf("TMW_Bench: %s\n", same? "same expiries" : "MISMATCH");
+	return(same? 0 : 1);
+}
+
+//==============================================================================
@@ -0,0 +1,88 @@
+//==============================================================================
+/** @file stm32f1xx.h (host)
+ *  @brief Host replacement of the CMSIS device header.
+ *  Only what the service layer (DRV_SSR, DRV_TMW, DRV_MSG, DRV_REG) touches:
+ *  the core registers become plain variables owned by the host backend and
+ *  the intrinsics become no-ops or compiler fences.
+ *  @version 1.0.0
+ *  @author J. Nilo Rodrigues - nilo@pobox.com
+ *
+ *------------------------------------------------------------------------------
+ *
+ * <h2><center>&copy; Copyright (c) 2020 Joao Nilo Rodrigues </center></h2>
+ * <h2><center> All rights reserved. </center></h2>
+ *
+ * This software component is licensed by "Joao Nilo Rodrigues" under BSD 3-Clause
+ * license, the "License".
+ * You may not use this file except in compliance with the License.
+ *               You may obtain a copy of the License at:
+ *                 opensource.org/licenses/BSD-3-Clause
+ *
+ *///---------------------------------------------------------------------------
+#ifndef HOST_STM32F1XX_H
+    #define HOST_STM32F1XX_H
+
+	#include <stdint.h>
+	#include <stdbool.h>
+
+#if defined(__arm__)
+	#error "Host/stm32f1xx.h is for host builds only"
+#endif
+
+//------------------------------------------------------------------------------
+// read-only registers stay writable: the host backend plays the hardware
+#define __IO							volatile
+#define __I								volatile
+
+// STM32F103xB interrupt numbers (the ones used by SSR_NVToIRQn)
+typedef enum{
+	NonMaskableInt_IRQn = -14, HardFault_IRQn = -13, SVCall_IRQn = -5, PendSV_IRQn = -2, SysTick_IRQn = -1,
+	WWDG_IRQn = 0, RTC_IRQn = 3, RCC_IRQn = 5,
+	EXTI0_IRQn = 6, EXTI1_IRQn = 7, EXTI2_IRQn = 8, EXTI3_IRQn = 9, EXTI4_IRQn = 10,
+	DMA1_Channel1_IRQn = 11, DMA1_Channel2_IRQn = 12, DMA1_Channel3_IRQn = 13, DMA1_Channel4_IRQn = 14,
+	DMA1_Channel5_IRQn = 15, DMA1_Channel6_IRQn = 16, DMA1_Channel7_IRQn = 17,
+	ADC1_2_IRQn = 18, USB_HP_CAN1_TX_IRQn = 19, USB_LP_CAN1_RX0_IRQn = 20, CAN1_RX1_IRQn = 21, CAN1_SCE_IRQn = 22,
+	EXTI9_5_IRQn = 23, TIM1_BRK_IRQn = 24, TIM1_UP_IRQn = 25, TIM1_TRG_COM_IRQn = 26, TIM1_CC_IRQn = 27,
+	TIM2_IRQn = 28, TIM3_IRQn = 29, TIM4_IRQn = 30, I2C1_EV_IRQn = 31, I2C1_ER_IRQn = 32, I2C2_EV_IRQn = 33,
+	I2C2_ER_IRQn = 34, SPI1_IRQn = 35, SPI2_IRQn = 36, USART1_IRQn = 37, USART2_IRQn = 38, USART3_IRQn = 39,
+	EXTI15_10_IRQn = 40, RTC_Alarm_IRQn = 41, USBWakeUp_IRQn = 42
+} IRQn_Type;
+
+typedef struct{ __I uint32_t CPUID; __IO uint32_t ICSR, VTOR, AIRCR, SCR, CCR; } SCB_Type;
+typedef struct{ __IO uint32_t CTRL, LOAD, VAL; __I uint32_t CALIB; } SysTick_Type;
+typedef struct{ __IO uint32_t CTRL, CYCCNT; } DWT_Type;
+typedef struct{ __IO uint32_t DHCSR, DCRSR, DCRDR, DEMCR; } CoreDebug_Type;
+
+extern SCB_Type HostSCB;
+extern SysTick_Type HostSysTick;
+extern DWT_Type HostDWT;
+extern CoreDebug_Type HostCoreDebug;
+extern uint32_t HostIPSR;
+extern uint32_t SystemCoreClock;
+
+#define SCB								(&HostSCB)
+#define SysTick							(&HostSysTick)
+#define DWT								(&HostDWT)
+#define CoreDebug						(&HostCoreDebug)
+
+#define SCB_ICSR_PENDSTSET_Msk			(1UL << 26)
+#define SCB_ICSR_VECTACTIVE_Msk			(0x1FFUL)
+#define DWT_CTRL_CYCCNTENA_Msk			(1UL << 0)
+#define CoreDebug_DEMCR_TRCENA_Msk		(1UL << 24)
+
+//------------------------------------------------------------------------------
+// single-threaded simulation: masking is a no-op, barriers are compiler fences
+static inline void __disable_irq(void){}
+static inline void __enable_irq(void){}
+static inline uint32_t __get_PRIMASK(void){ return(0);}
+static inline void __set_PRIMASK(uint32_t){}
+static inline uint32_t __get_IPSR(void){ return(HostIPSR);}
+static inline void __DMB(void){ __atomic_thread_fence(__ATOMIC_SEQ_CST);}
+static inline void __DSB(void){ __atomic_thread_fence(__ATOMIC_SEQ_CST);}
+static inline void __ISB(void){ __atomic_thread_fence(__ATOMIC_SEQ_CST);}
+static inline void __WFI(void){}
+#define __BKPT(value)					__builtin_trap()
+static inline uint8_t __CLZ(uint32_t v){ return((uint8_t)(v? __builtin_clz(v) : 32));}
+
+#endif
+//==============================================================================
@@ -0,0 +1,168 @@
+//==============================================================================
+/** @file DRV_CAP.h
+ *  @brief Port Capture (logic analyzer) Driver
+ *  A timer paces DMA reads of a port's IDR into a circular buffer, so the
+ *  whole port is sampled at a fixed rate with no jitter. The half/full
+ *  transfer interrupts look for a trigger pattern and stop the capture a
+ *  given number of samples after it; the samples can then be run-length
+ *  compressed from the event loop.
+ *  @version 1.0.0
+ *  @author J. Nilo Rodrigues - nilo@pobox.com
+ *
+ *------------------------------------------------------------------------------
+ *
+ * <h2><center>&copy; Copyright (c) 2020 Joao Nilo Rodrigues </center></h2>
+ * <h2><center> All rights reserved. </center></h2>
+ *
+ * This software component is licensed by "Joao Nilo Rodrigues" under BSD 3-Clause
+ * license, the "License".
+ * You may not use this file except in compliance with the License.
+ *               You may obtain a copy of the License at:
+ *                 opensource.org/licenses/BSD-3-Clause
+ *
+ *///---------------------------------------------------------------------------
+#ifndef DRV_CAP_H
+    #define DRV_CAP_H
+
+	#include <stddef.h>
+	#include "stm32f1xx.h"
+	#include "GenericTypeDefs.h"
+	#include "Priorities.h"
+
+//------------------------------------------------------------------------------
+/**
+ * @def CAP_TIMER
+ * - timer pacing the capture and the DMA1 channel of its UP request:
+ * TIM4 (channel 7), TIM2 (channel 2), TIM3 (channel 3), or TIM1 (channel 5)
+ * with CAP_TIMER_APB2 defined.
+ * @def CAP_PRIORITY
+ * - interrupt priority of the DMA channel (trigger search runs there)
+ */
+#ifndef CAP_TIMER
+	#define CAP_TIMER				TIM4
+	#define CAP_TIMER_CLOCK			RCC_APB1ENR_TIM4EN
+	#define CAP_DMA					DMA1_Channel7
+	#define CAP_DMA_IRQn			DMA1_Channel7_IRQn
+#endif
+
+#ifndef CAP_PRIORITY
+	#define CAP_PRIORITY			SYS_PRIORITY_LEVEL_3
+#endif
+
+#define CAP_CONTINUOUS				((uint32_t) 0xFFFFFFFF)	//!< PostTrigger value: never stop
+
+#define CAP_EVENT_HALF				((uint32_t) 0x01)		//!< first half of the buffer filled
+#define CAP_EVENT_FULL				((uint32_t) 0x02)		//!< second half of the buffer filled
+#define CAP_EVENT_TRIGGER			((uint32_t) 0x04)		//!< trigger pattern found
+#define CAP_EVENT_DONE				((uint32_t) 0x08)		//!< capture stopped
+
+/**
+ * @brief Capture event callback, called from the DMA interrupt.
+ * @arg Event: CAP_EVENT_* (or-ed)
+ * @arg Context: the context pointer given to CAP_Start()
+ */
+typedef void (*CAP_Callback)(uint32_t Event, void* Context);
+
+/**
+ * @brief Trigger: the first sample with (Sample & Mask) == Value.
+ * A zero Mask triggers on the first sample.
+ */
+struct CAP_Trigger{
+	uint16_t Mask;					//!< pins compared
+	uint16_t Value;					//!< levels expected on those pins
+};
+
+/**
+ * @brief Run-length compressed sample: Value held for Length samples.
+ */
+struct CAP_Run{
+	uint16_t Value;					//!< port levels
+	uint16_t Length;				//!< number of samples (1 to 65535)
+};
+
+/**
+ *  @defgroup DRV_CAP
+ *  @{
+ */
+
+//------------------------------------------------------------------------------
+/**
+ * @brief CAP_Initialize
+ * - Turns the timer and DMA clocks on and installs the DMA interrupt handler.
+ */
+void CAP_Initialize();
+
+/**
+ * @brief CAP_Start
+ * - Starts sampling a port into a circular buffer.
+ * @arg Port is the port "base-address" (i. e. GPIOA, GPIOB, etc)
+ * @arg Buffer: the sample buffer (one IDR sample per entry)
+ * @arg Count: the buffer size, in samples (even)
+ * @arg Frequency: samples per second (the timer update rate)
+ * @arg Trigger: the trigger pattern
+ * @arg PostTrigger: samples kept after the trigger (up to Count / 2, so the
+ * trigger stays in the buffer), or CAP_CONTINUOUS to sample until CAP_Stop()
+ * @arg Callback: optional event callback (may be NULL)
+ * @arg Context: the callback context pointer
+ * @return false if a capture is already running or the arguments are invalid.
+ * @note The trigger is searched a half buffer at a time, from the interrupt.
+ */
+bool CAP_Start(GPIO_TypeDef* Port, uint16_t* Buffer, uint16_t Count, uint32_t Frequency,
+		const CAP_Trigger& Trigger, uint32_t PostTrigger, CAP_Callback Callback, void* Context);
+
+/**
+ * @brief CAP_Stop
+ * - Stops the capture; the samples taken so far stay available.
+ */
+void CAP_Stop();
+
+/**
+ * @brief CAP_IsBusy
+ * @return true while the capture is running.
+ */
+bool CAP_IsBusy();
+
+/**
+ * @brief CAP_GetSamples
+ * @return the number of valid samples of the last capture.
+ */
+uint32_t CAP_GetSamples();
+
+/**
+ * @brief CAP_GetSample
+ * @arg Index: chronological sample index (0 = oldest)
+ * @return the sample.
+ */
+uint16_t CAP_GetSample(uint32_t Index);
+
+/**
+ * @brief CAP_GetTrigger
+ * @return the chronological index of the trigger sample, or CAP_CONTINUOUS
+ * if the trigger was not found.
+ */
+uint32_t CAP_GetTrigger();
+
+/**
+ * @brief CAP_Compress
+ * - Run-length compresses the last capture, oldest sample first.
+ * @arg Runs: the output
+ * @arg Max: the output size, in runs
+ * @return the number of runs written (Max if the output was too small).
+ * @note Meant for the event loop, once the capture is done.
+ */
+uint32_t CAP_Compress(CAP_Run* Runs, uint32_t Max);
+
+/**
+ * @brief CAP_Handler
+ * - DMA channel interrupt handler (installed by CAP_Initialize()).
+ * @note SSR_FLASH_VECTORS builds need X(NV_DMA1_CH7, CAP_Handler) (the
+ * vector of CAP_DMA) in SSR_FLASH_HANDLERS.
+ */
+extern "C" void CAP_Handler(void);
+
+/**
+ * @} // close group DRV_CAP
+ */
+
+#endif
+//==============================================================================
@@ -41,6 +41,39 @@ extern "C"{
 #define __WATCHDOG_FLAG_SET             0x20000000
 #define __WATCHDOG_FLAG_REMOVER         0x01000000
 
+#define CPU_WARMSTART_MAGIC				((uint32_t)0x5741524D)
+#define CPU_COLDRESET_KEY				((uint32_t)0x05FA0004)
+
+#ifndef CPU_NOINIT_WORDS
+	#define CPU_NOINIT_WORDS			8
+#endif
+
+/**
+ * @def CPU_NOINIT
+ * - places a variable in the ".noinit" RAM section, which is neither loaded nor
+ * cleared by the startup code. The linker script must provide it, i. e.:
+ * @code
+ *  .noinit (NOLOAD) : { . = ALIGN(4); *(.noinit) *(.noinit*) . = ALIGN(4); } >RAM
+ * @endcode
+ */
+#define CPU_NOINIT						__attribute__((section(".noinit")))
+
+/**
+ * @def CPU_RAMFUNC
+ * - places a function (i. e. a hot ISR and its callees) in the ".RamFunc" section,
+ * which runs from SRAM without flash wait states. The ST linker scripts already
+ * copy it together with ".data"; otherwise add to the ".data" output section:
+ * @code
+ *  *(.RamFunc) *(.RamFunc*)
+ * @endcode
+ * @note long_call is required since SRAM is out of the BL range of the flash code.
+ */
+#if defined(__ICCARM__)
+	#define CPU_RAMFUNC					__ramfunc
+#else
+	#define CPU_RAMFUNC					__attribute__((section(".RamFunc"), noinline, long_call))
+#endif
+
 //==============================================================================
 #define HSE_Value               ((uint32_t) 8000000)
 #define HSI_Value               ((uint32_t) 8000000)
@@ -117,6 +150,18 @@ enum BusFrequencies { 	HCLK_DIV1  = 0,		//!< APBx clock frequency is (HCLK / 1)
  * @}
  */
 
+/**
+ * @brief Warm restart data block.
+ * - This structure lives in the ".noinit" section and survives a CPU_WarmReset().
+ */
+struct CPU_NoInitBlock{
+	uint32_t Magic;						//!< CPU_WARMSTART_MAGIC when sealed by CPU_WarmReset()
+	uint32_t Reason;					//!< application defined restart reason
+	uint32_t Restarts;					//!< number of consecutive warm restarts
+	uint32_t Data[CPU_NOINIT_WORDS];	//!< application data preserved across warm restarts
+	uint32_t Crc;						//!< CPU_Crc32() of all the fields above
+};
+
 #ifdef __cplusplus
 }
 #endif
@@ -147,6 +192,8 @@ void CPU_StartHSI();
  * @arg CpuSpeed
  * - the desired clock speed for the microcontroller unit.
  * The CPUSpeed enumeration provides the options for this parameter.
+ * @note If the PLL is already locked and driving SYSCLK with the requested
+ * source and factors (i. e. after a CPU_WarmReset) the oscillators are not restarted.
  */
 void CPU_StartPLL(PllSources PllSource, PllFrequencies CpuSpeed);
 
@@ -264,6 +311,50 @@ void CPU_KickWatchdog();
  */
 void CPU_Reset();
 
+/**
+ * @brief CPU_WarmReset
+ * - Restarts the application without a system reset.
+ * The no-init block is sealed (magic + CRC), the interrupts are masked and
+ * cleared, the peripherals are reset through the RCC reset registers, then
+ * the stack pointer is reloaded from the boot table and Reset_Handler runs
+ * again. The clock tree (HSE, PLL, prescalers), the backup domain and the
+ * PWR settings are kept, so after a CPU_WarmReset the PLL is already
+ * configured and CPU_StartPLL() does not restart the oscillators.
+ * @arg Reason is an application defined code, available after restart in CPU_GetNoInit().
+ * @note Called from an interrupt handler (or unprivileged) it falls back to a
+ * cold system reset (SYSRESETREQ); the no-init block still survives it.
+ * @note Restarts only counts on when the previous block was valid (CRC checked).
+ * @note The startup code must skip SystemInit() on warm starts (see
+ * CPU_IsWarmStart()), otherwise the RCC is taken back to HSI and the PLL has
+ * to lock again.
+ */
+void CPU_WarmReset(uint32_t Reason);
+
+/**
+ * @brief CPU_IsWarmStart
+ * - Same check as CPU_CheckWarmStart(), without consuming the magic.
+ * @return true if the no-init block is sealed and valid (magic and CRC match).
+ * @note It uses neither .data nor .bss, so it can be called from the startup
+ * code (C linkage) before they are initialized.
+ */
+extern "C" bool CPU_IsWarmStart(void);
+
+/**
+ * @brief CPU_CheckWarmStart
+ * - Checks if the current start was caused by CPU_WarmReset().
+ * @return true if the no-init block is valid (magic and CRC match).
+ * @note The magic is consumed, so any later reset that does not go through
+ * CPU_WarmReset() is seen as a cold start.
+ */
+bool CPU_CheckWarmStart();
+
+/**
+ * @brief CPU_GetNoInit
+ * - Returns the no-init block, where the application can keep data across warm restarts.
+ * @note Its content is undefined after a cold start.
+ */
+CPU_NoInitBlock* CPU_GetNoInit();
+
 /**
  * @brief CPU_SetPriorityIRQn
  * - Sets the priority for a given IQRn in NVIC.
@@ -0,0 +1,109 @@
+//==============================================================================
+/** @file DRV_DEB.h
+ *  @brief Input Debouncer
+ *  Samples the IDR of whole ports on a periodic tick and debounces all their
+ *  pins in parallel with 2-bit vertical counters (a pin must read the same
+ *  for DEB_SAMPLES consecutive ticks), then posts the stable edges as one
+ *  NMESSAGE per port. A single periodic interrupt replaces the EXTI storm
+ *  of mechanical contacts.
+ *  @version 1.0.0
+ *  @author J. Nilo Rodrigues - nilo@pobox.com
+ *
+ *------------------------------------------------------------------------------
+ *
+ * <h2><center>&copy; Copyright (c) 2020 Joao Nilo Rodrigues </center></h2>
+ * <h2><center> All rights reserved. </center></h2>
+ *
+ * This software component is licensed by "Joao Nilo Rodrigues" under BSD 3-Clause
+ * license, the "License".
+ * You may not use this file except in compliance with the License.
+ *               You may obtain a copy of the License at:
+ *                 opensource.org/licenses/BSD-3-Clause
+ *
+ *///---------------------------------------------------------------------------
+#ifndef DRV_DEB_H
+    #define DRV_DEB_H
+
+	#include <stddef.h>
+	#include "stm32f1xx.h"
+	#include "GenericTypeDefs.h"
+
+//------------------------------------------------------------------------------
+/**
+ * @def DEB_PORTS
+ * - maximum number of ports being debounced
+ * @def DEB_LANE
+ * - message lane of the edge notifications (see DRV_MSG)
+ */
+#ifndef DEB_PORTS
+	#define DEB_PORTS				3
+#endif
+
+#ifndef DEB_LANE
+	#define DEB_LANE				MSG_LANE_NORMAL
+#endif
+
+#define DEB_SAMPLES					4			//!< consecutive equal samples for a stable level
+
+/**
+ *  @defgroup DRV_DEB
+ *  @{
+ */
+
+//------------------------------------------------------------------------------
+/**
+ * @brief DEB_Add
+ * - Adds pins to the debouncer. The current levels are taken as the stable
+ * state, so no event is posted for them.
+ * @arg Port is the port "base-address" (i. e. GPIOA, GPIOB, etc)
+ * @arg Mask is the set of pins to debounce (bit n = pin n), added to the
+ * pins of the port already debounced.
+ * @arg Message is the message ID of the notifications: data1 holds the pins
+ * that changed, data2 the new stable levels of all the pins in Mask and tag
+ * the port index (0: GPIOA, 1: GPIOB, etc). Rising pins are data1 & data2,
+ * falling pins data1 & ~data2.
+ * @return false if all DEB_PORTS entries are in use.
+ * @note The pins must be configured as inputs (IO_PinInit()), without Int.
+ */
+bool DEB_Add(GPIO_TypeDef* Port, uint16_t Mask, uint32_t Message);
+
+/**
+ * @brief DEB_Remove
+ * - Stops debouncing a port.
+ */
+void DEB_Remove(GPIO_TypeDef* Port);
+
+/**
+ * @brief DEB_GetState
+ * @return the debounced levels of the port (only the debounced pins are valid).
+ */
+uint16_t DEB_GetState(GPIO_TypeDef* Port);
+
+/**
+ * @brief DEB_Tick
+ * - Samples and debounces every port, posting the stable edges.
+ * @note Called by the periodic timer of DEB_Start(), or by any other periodic
+ * interrupt of the application.
+ */
+void DEB_Tick();
+
+/**
+ * @brief DEB_Start
+ * - Calls DEB_Tick() every Period milliseconds, from a DRV_TMW timer.
+ * @arg Period: the sampling period (the debounce time is DEB_SAMPLES periods)
+ * @return false if no wheel timer is available.
+ */
+bool DEB_Start(uint32_t Period);
+
+/**
+ * @brief DEB_Stop
+ * - Stops the periodic sampling.
+ */
+void DEB_Stop();
+
+/**
+ * @} // close group DRV_DEB
+ */
+
+#endif
+//==============================================================================
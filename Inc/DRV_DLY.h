@@ -0,0 +1,148 @@
+//==============================================================================
+/** @file DRV_DLY.h
+ *  @brief Deferred Delay Kernel Driver
+ *  Non-blocking counterpart of SSR_Delay() / SSR_MicroDelay(): the delay is
+ *  programmed as a one-shot compare on a free-running 1 MHz timer and only the
+ *  caller's continuation waits for it, while the event loop keeps dispatching
+ *  messages (or sleeps in WFI when there is nothing else to do).
+ *  @version 1.0.0
+ *  @author J. Nilo Rodrigues - nilo@pobox.com
+ *
+ *------------------------------------------------------------------------------
+ *
+ * <h2><center>&copy; Copyright (c) 2020 Joao Nilo Rodrigues </center></h2>
+ * <h2><center> All rights reserved. </center></h2>
+ *
+ * This software component is licensed by "Joao Nilo Rodrigues" under BSD 3-Clause
+ * license, the "License".
+ * You may not use this file except in compliance with the License.
+ *               You may obtain a copy of the License at:
+ *                 opensource.org/licenses/BSD-3-Clause
+ *
+ *///---------------------------------------------------------------------------
+#ifndef DRV_DLY_H
+    #define DRV_DLY_H
+
+	#include <stddef.h>
+	#include "stm32f1xx.h"
+	#include "GenericTypeDefs.h"
+	#include "Priorities.h"
+
+//------------------------------------------------------------------------------
+/**
+ * @def DLY_TIMER
+ * - general purpose timer used as delay time base (TIM2, TIM3 or TIM4).
+ * Each of its 4 compare channels holds one pending delay.
+ * @def DLY_PRIORITY
+ * - interrupt priority of the delay timer
+ */
+#ifndef DLY_TIMER
+	#define DLY_TIMER				TIM2
+	#define DLY_TIMER_IRQn			TIM2_IRQn
+	#define DLY_TIMER_CLOCK			RCC_APB1ENR_TIM2EN
+#endif
+
+#ifndef DLY_PRIORITY
+	#define DLY_PRIORITY			SYS_PRIORITY_LEVEL_2
+#endif
+
+#define DLY_CHANNELS				4
+#define DLY_NONE					((uint32_t) 0xFFFFFFFF)
+
+/**
+ * @if cond_macros
+ */
+#define DLY_INDEX_MASK				((uint32_t) 0x0000FFFF)
+#define DLY_GENERATION_SHIFT		16
+/**
+ * @endif
+ */
+
+/**
+ * @brief Delay continuation, called by DLY_Dispatch() when the delay is over.
+ * @arg Context: the context pointer given to DLY_Defer()
+ */
+typedef void (*DLY_Continuation)(void* Context);
+
+/**
+ *  @defgroup DRV_DLY
+ *  @{
+ */
+
+//------------------------------------------------------------------------------
+/**
+ * @brief DLY_Initialize
+ * - Starts the delay timer at 1 MHz and installs its interrupt handler.
+ * @note Must be called again after the system clock changes.
+ */
+void DLY_Initialize();
+
+/**
+ * @brief DLY_Defer
+ * - Schedules a continuation to run after the given time, without blocking.
+ * @arg Microseconds: the delay (any 32 bit value)
+ * @arg Continuation: the function to be called once the delay expires
+ * @arg Context: the continuation context pointer
+ * @return the delay handle (generation << 16 | channel), or DLY_NONE if all
+ * channels are busy.
+ * @note The continuation runs from DLY_Dispatch(), not from the interrupt.
+ * @note The handle goes stale when the delay is cancelled or its continuation
+ * is dispatched, so it never refers to a later delay on the same channel.
+ */
+uint32_t DLY_Defer(uint32_t Microseconds, DLY_Continuation Continuation, void* Context);
+
+/**
+ * @brief DLY_DeferMs
+ * - Same as DLY_Defer(), with the delay given in milliseconds.
+ * @return DLY_NONE also when Milliseconds exceeds 4294967 (0xFFFFFFFF us).
+ */
+uint32_t DLY_DeferMs(uint32_t Milliseconds, DLY_Continuation Continuation, void* Context);
+
+/**
+ * @brief DLY_Cancel
+ * - Cancels a pending delay (its continuation is not called).
+ * @arg Handle: the value returned by DLY_Defer()
+ * @return false if the handle is stale (the delay was already dispatched or
+ * cancelled), in which case nothing is cancelled.
+ */
+bool DLY_Cancel(uint32_t Handle);
+
+/**
+ * @brief DLY_Dispatch
+ * - Runs the continuations of the expired delays.
+ * @return the number of continuations executed.
+ * @note To be called from the event loop, between message dispatches.
+ */
+uint32_t DLY_Dispatch();
+
+/**
+ * @brief DLY_IsPending
+ * @return true if any delay is still running or waiting for DLY_Dispatch().
+ */
+bool DLY_IsPending();
+
+/**
+ * @brief DLY_Idle
+ * - Sleeps (WFI) until the next interrupt, unless a continuation is ready
+ * or IsIdle returns false.
+ * @arg IsIdle: optional check of the caller's own queues (may be NULL)
+ * @note Both checks are done with interrupts masked, so an event raised just
+ * before WFI still wakes the core up (no lost wake-up). The caller's PRIMASK
+ * is restored on return.
+ */
+void DLY_Idle(bool (*IsIdle)(void));
+
+/**
+ * @brief DLY_Handler
+ * - Delay timer interrupt handler (installed by DLY_Initialize()).
+ * @note With SSR_FLASH_VECTORS it must be in SSR_FLASH_HANDLERS, i. e.
+ * X(NV_TIM2, DLY_Handler) for the default DLY_TIMER.
+ */
+extern "C" void DLY_Handler(void);
+
+/**
+ * @} // close group DRV_DLY
+ */
+
+#endif
+//==============================================================================
@@ -38,7 +38,7 @@ extern "C"{
 #define DMA_CCR_ALL            	   (DMA_CCR_TCIE | DMA_CCR_HTIE | DMA_CCR_TEIE)
 #define DMA_CCR_BYTES              0
 #define DMA_CCR_WORDS              (DMA_CCR_PSIZE_0 | DMA_CCR_MSIZE_0)
-//#define DMA_CCR_DWORDS             (DMA_CCR_PSIZE_1 | DMA_CCR_MSIZE_1)
+#define DMA_CCR_DWORDS             (DMA_CCR_PSIZE_1 | DMA_CCR_MSIZE_1)
 #define DMA_CCR_SEND_BYTES         (DMA_CCR_ISR_COM | DMA_CCR_DIR | DMA_CCR_MINC | DMA_CCR_BYTES)
 //#define DMA_CCR_BLK_SEND_BYTES     (DMA_CCR1_DIR | DMA_CCR1_MINC | DMA_CCR_BYTES)
 #define DMA_CCR_RECEIVE_BYTES      ((DMA_CCR_TCIE | DMA_CCR_TEIE) | DMA_CCR_MINC | DMA_CCR_BYTES)
@@ -46,8 +46,10 @@ extern "C"{
 //#define DMA_CCR_EN                  DMA_CCR_EN
 //#define DMA_CCR_BLK_RECEIVE_BYTES   (DMA_CCR_ISR_COM | DMA_CCR1_MINC | DMA_CCR_BYTES)
 //#define DMA_CCR_PUSH_BYTES          (DMA_CCR_ISR_COM | DMA_CCR1_DIR | DMA_CCR_BYTES)
-//#define DMA_CCR_MOVE_BYTES          (DMA_CCR1_PINC | DMA_CCR1_MINC | DMA_CCR_BYTES | DMA_CCR1_MEM2MEM)
+#define DMA_CCR_MOVE_BYTES         ((DMA_CCR_TCIE | DMA_CCR_TEIE) | DMA_CCR_PINC | DMA_CCR_MINC | DMA_CCR_BYTES | DMA_CCR_MEM2MEM)
+#define DMA_CCR_COPY_WORDS         (DMA_CCR_DIR | DMA_CCR_PINC | DMA_CCR_MINC | DMA_CCR_DWORDS | DMA_CCR_MEM2MEM)
 //#define DMA_CCR_RECEIVE_WORDS       (DMA_CCR_ISR_COM | DMA_CCR1_MINC | DMA_CCR_WORDS)
+#define DMA_CCR_STREAM_WORDS       ((DMA_CCR_TCIE | DMA_CCR_TEIE) | DMA_CCR_DIR | DMA_CCR_MINC | DMA_CCR_DWORDS)
 #define DMA_CCR_RECEIVE_ADC        (DMA_CCR_ISR_ALL | DMA_CCR_CIRC | DMA_CCR_MINC | DMA_CCR_WORDS)
 //#define CHANNEL_DEFAULT_PROFILE     DMA_CCR_SEND_BYTES
 
@@ -130,8 +132,11 @@ bool DMA_CheckInterrupts(DMA_Channel_TypeDef* CHn, uint32_t Flag);
 
 /**
  * @brief DMA_WaitFreeChannel
- * - This function locks the execution until the current DMA transfer ends.
+ * - This function locks the execution until the current DMA transfer ends
+ * (all the data moved, an error, or the channel disabled).
  * @arg CHn is the DMA channel
+ * @note The TC/TE flags are left as they are, for the caller or the channel
+ * handler. Not for circular transfers, which never end.
  */
 void DMA_WaitFreeChannel(DMA_Channel_TypeDef* CHn);
 
@@ -147,6 +152,26 @@ void DMA_WaitFreeChannel(DMA_Channel_TypeDef* CHn);
  */
 bool DMA_Move(DMA_Channel_TypeDef* CHn, uint8_t* SrcAddr, uint8_t* DstAddr, uint16_t N);
 
+/**
+ * @brief DMA_Start
+ * - Programs and enables a channel for a peripheral transfer.
+ * @arg CHn is the DMA channel
+ * @arg Paddr the peripheral register address (i. e. &GPIOB->BSRR).
+ * @arg Maddr the memory buffer address.
+ * @arg N the number of data items.
+ * @arg Config the CCR value (i. e. DMA_CCR_STREAM_WORDS | DMA_CCR_CIRC), without DMA_CCR_EN.
+ * @return the operation result (false if the channel is busy).
+ */
+bool DMA_Start(DMA_Channel_TypeDef* CHn, volatile void* Paddr, const void* Maddr, uint16_t N, uint32_t Config);
+
+/**
+ * @brief DMA_Stop
+ * - Disables a channel and clears its interrupt flags.
+ * @arg CHn is the DMA channel
+ * @return the number of data items not transferred (CNDTR).
+ */
+uint16_t DMA_Stop(DMA_Channel_TypeDef* CHn);
+
 /**
  * @} // close group DRV_DMA
  */
@@ -0,0 +1,177 @@
+//==============================================================================
+/** @file DRV_EXT.h
+ *  @brief External Interrupt (EXTI) Dispatcher
+ *  One interrupt handler serves the seven EXTI vectors: the lines of the
+ *  active vector are found from IPSR, the pending ones are read once
+ *  (PR & IMR), walked with CLZ and each is acknowledged with a single PR
+ *  write before its handler is called from a per-line table. Noisy lines
+ *  can be given a holdoff: after an edge the line stays masked for a while
+ *  and the edges in between are coalesced into (at most) one more event.
+ *  Pulse inputs can also get a ring of DWT cycle stamps, one per edge, from
+ *  which period, frequency and duty cycle are worked out only when read.
+ *  @version 1.0.0
+ *  @author J. Nilo Rodrigues - nilo@pobox.com
+ *
+ *------------------------------------------------------------------------------
+ *
+ * <h2><center>&copy; Copyright (c) 2020 Joao Nilo Rodrigues </center></h2>
+ * <h2><center> All rights reserved. </center></h2>
+ *
+ * This software component is licensed by "Joao Nilo Rodrigues" under BSD 3-Clause
+ * license, the "License".
+ * You may not use this file except in compliance with the License.
+ *               You may obtain a copy of the License at:
+ *                 opensource.org/licenses/BSD-3-Clause
+ *
+ *///---------------------------------------------------------------------------
+#ifndef DRV_EXT_H
+    #define DRV_EXT_H
+
+	#include <stddef.h>
+	#include "stm32f1xx.h"
+	#include "GenericTypeDefs.h"
+	#include "DRV_IO.h"
+
+//------------------------------------------------------------------------------
+#define EXT_LINES					16				//!< GPIO lines (EXTI0 to EXTI15)
+
+/**
+ * @brief Line handler, called from the EXTI interrupt.
+ * @arg Line: the EXTI line (pin number) which fired
+ * @arg Context: the context pointer given to EXT_Attach()
+ */
+typedef void (*EXT_Callback)(uint32_t Line, void* Context);
+
+/**
+ * @def EXT_STAMPS
+ * - edges kept in each timestamp ring (must be a power of two)
+ */
+#ifndef EXT_STAMPS
+	#define EXT_STAMPS				16
+#endif
+
+/**
+ * @brief Edge timestamp ring of one line (owned by the application).
+ */
+struct EXT_Stamps{
+	volatile uint32_t Head;				//!< number of edges stored (next = Head % EXT_STAMPS)
+	uint32_t Stamps[EXT_STAMPS];		//!< DWT->CYCCNT at the edge, bit 0 = level after it (1: rising)
+};
+
+/**
+ * @brief Pulse statistics over the edges in a ring (0 when unknown).
+ */
+struct EXT_Measure{
+	uint32_t Edges;						//!< edges used
+	uint32_t Period;					//!< mean period, in core cycles
+	uint32_t Frequency;					//!< mean frequency, in mHz
+	uint32_t High;						//!< mean high time, in core cycles
+	uint32_t Low;						//!< mean low time, in core cycles
+	uint32_t Duty;						//!< high time / period, in per mille
+};
+
+/**
+ *  @defgroup DRV_EXT
+ *  @{
+ */
+
+//------------------------------------------------------------------------------
+/**
+ * @brief EXT_Attach
+ * - Sets the handler of an EXTI line and installs EXT_Handler() in the line's
+ * vector. The pin itself is configured by IO_PinInit() (Int = 1).
+ * @arg Line: the EXTI line (pin number, 0 to 15)
+ * @arg Callback: the line handler
+ * @arg Context: the handler context pointer
+ * @return false if Line is out of range.
+ */
+bool EXT_Attach(uint32_t Line, EXT_Callback Callback, void* Context);
+
+/**
+ * @brief EXT_Detach
+ * - Removes the handler of an EXTI line; its interrupts are still acknowledged.
+ */
+void EXT_Detach(uint32_t Line);
+
+/**
+ * @brief EXT_SetHoldoff
+ * - Enables interrupt coalescing on a line: after each served edge the line
+ * is masked for the holdoff time, then re-enabled by a DRV_TMW timer. An
+ * edge latched meanwhile (or, failing that, a level change in the direction
+ * of an enabled trigger) raises one more interrupt when the line is re-enabled.
+ * @arg Line: the EXTI line (pin number, 0 to 15)
+ * @arg Milliseconds: the holdoff time in TMW ticks (0: one interrupt per edge)
+ * @return false if Line is out of range.
+ * @note Uses one wheel timer per line in holdoff.
+ */
+bool EXT_SetHoldoff(uint32_t Line, uint32_t Milliseconds);
+
+/**
+ * @brief EXT_GetCount
+ * @return the number of events served on the line (handler calls).
+ * @note With a holdoff this is not the edge count: the edges within one
+ * holdoff window are served as (at most) one more event, and the number of
+ * edges they stood for is not known. See EXT_GetCoalesced().
+ */
+uint32_t EXT_GetCount(uint32_t Line);
+
+/**
+ * @brief EXT_GetCoalesced
+ * @return the number of holdoff windows in which edges were coalesced, i. e.
+ * an edge was latched while the line was masked, or the level at the end of
+ * the window differed from the level at its start. Each such window was
+ * served as one event, whatever the number of edges in it; 0 means no edge
+ * fell in a holdoff window and EXT_GetCount() is the exact edge count.
+ */
+uint32_t EXT_GetCoalesced(uint32_t Line);
+
+/**
+ * @brief EXT_SetTimestamps
+ * - Stores the DWT cycle count (and the input level) of every edge of a line
+ * in a ring, from EXT_Handler(); the DWT cycle counter is enabled here.
+ * @arg Port is the port "base-address" (i. e. GPIOA, GPIOB, etc)
+ * @arg PinConfig is the line's pin configuration (see IO_SetExtendedIT()).
+ * @arg Ring: the timestamp ring, NULL to stop stamping
+ * @return false if the pin is out of range.
+ * @note The stamp is taken in the handler when the line is acknowledged, so
+ * it trails the edge by the interrupt latency: the entry (12 cycles at best),
+ * any higher priority handler running meanwhile, plus the callbacks of the
+ * higher numbered lines served before it in the same pass. Only the spread
+ * of that latency shows up in Period, High and Low.
+ * @note With a single trigger (Rise or Fall) the level comes from the trigger
+ * and is always right. With both, the input is read in the handler, so a pulse
+ * shorter than the interrupt latency (or two edges served in one pass) may get
+ * the level of a later edge; High, Low and Duty are then unreliable.
+ */
+bool EXT_SetTimestamps(GPIO_TypeDef* Port, IO_Config* PinConfig, EXT_Stamps* Ring);
+
+/**
+ * @brief EXT_GetMeasure
+ * - Computes the pulse statistics of the edges currently in a line's ring.
+ * The period is taken between edges of the same direction; High, Low and
+ * Duty need both edges enabled (Rise and Fall).
+ * @arg Line: the EXTI line (pin number, 0 to 15)
+ * @arg Result: the statistics
+ * @return false if the line has no ring or fewer than two edges.
+ * @note Stamps older than 2^32 cycles (about 1 min at 72 MHz) are ambiguous.
+ * @note The stamps carry the interrupt latency (see EXT_SetTimestamps()), so
+ * edges closer than the latency jitter give unreliable figures.
+ */
+bool EXT_GetMeasure(uint32_t Line, EXT_Measure& Result);
+
+/**
+ * @brief EXT_Handler
+ * - Interrupt handler of all EXTI vectors (installed by EXT_Attach()).
+ * @note Lines pending again while their handler runs are served in the same
+ * interrupt, without going back through the NVIC.
+ * @note With SSR_FLASH_VECTORS list it for every EXTI vector in use, i. e.
+ * X(NV_EXTINT0, EXT_Handler) and X(NV_EXTINT5, EXT_Handler).
+ */
+extern "C" void EXT_Handler(void);
+
+/**
+ * @} // close group DRV_EXT
+ */
+
+#endif
+//==============================================================================
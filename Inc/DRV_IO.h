@@ -279,6 +279,90 @@ void IO_PortClockEnable(GPIO_TypeDef* Port);
  */
 void IO_PinInit(GPIO_TypeDef* Port, IO_Config* PinStruct);
 
+/**
+ * @brief IO_PortConfig
+ * - Configures several pins of the same port in one pass: the CRL/CRH and ODR
+ * words are computed first, then the output levels are written through BSRR
+ * and each CRx register is written once, so no pin goes through an
+ * intermediate mode.
+ * @arg Port is the port "base-address" (i. e. GPIOA, GPIOB, etc)
+ * @arg Pins is an array of @ref IO_Config, one entry per pin.
+ * @arg Count is the number of entries in Pins.
+ */
+void IO_PortConfig(GPIO_TypeDef* Port, IO_Config* Pins, uint32_t Count);
+
+/**
+ * @brief IO_PortInit
+ * - Same as IO_PortConfig(), with a single configuration for every pin in Mask.
+ * @arg Port is the port "base-address" (i. e. GPIOA, GPIOB, etc)
+ * @arg Mask is the set of pins to configure (bit n = pin n).
+ * @arg PinConfig is the configuration to apply (its "Pin" field is ignored).
+ */
+void IO_PortInit(GPIO_TypeDef* Port, uint16_t Mask, IO_Config* PinConfig);
+
+//------------------------------------------------------------------------------
+/**
+ * @brief IO_Set
+ * - Drives high the pins in Mask (single BSRR store, atomic).
+ * @arg Port is the port "base-address" (i. e. GPIOA, GPIOB, etc)
+ * @arg Mask is the set of pins (bit n = pin n).
+ */
+inline void IO_Set(GPIO_TypeDef* Port, uint32_t Mask){ Port->BSRR = Mask;}
+
+/**
+ * @brief IO_Clear
+ * - Drives low the pins in Mask (single BRR store, atomic).
+ */
+inline void IO_Clear(GPIO_TypeDef* Port, uint32_t Mask){ Port->BRR = Mask;}
+
+/**
+ * @brief IO_Write
+ * - Drives the pins in Mask to the matching bits of Value, all in the same
+ * BSRR store; the other pins of the port are not touched.
+ * @arg Mask is the set of pins to write.
+ * @arg Value holds the new levels (bit n = pin n).
+ */
+inline void IO_Write(GPIO_TypeDef* Port, uint32_t Mask, uint32_t Value){
+	Port->BSRR = (Value & Mask) | ((~Value & Mask) << 16);
+}
+
+/**
+ * @brief IO_Toggle
+ * - Inverts the pins in Mask: one ODR read and one BSRR store.
+ * @note Only the pins in Mask depend on the read, so an interrupt changing
+ * other pins of the same port is never undone.
+ */
+inline void IO_Toggle(GPIO_TypeDef* Port, uint32_t Mask){
+	uint32_t odr = Port->ODR;
+	Port->BSRR = (~odr & Mask) | ((odr & Mask) << 16);
+}
+
+/**
+ * @brief IO_Read
+ * @return the input levels (IDR) of the pins in Mask.
+ */
+inline uint32_t IO_Read(GPIO_TypeDef* Port, uint32_t Mask){ return(Port->IDR & Mask);}
+
+/**
+ * @brief IO_ReadOutput
+ * @return the driven levels (ODR) of the pins in Mask.
+ */
+inline uint32_t IO_ReadOutput(GPIO_TypeDef* Port, uint32_t Mask){ return(Port->ODR & Mask);}
+
+/**
+ * @brief IO_PinSet, IO_PinClear, IO_PinWrite, IO_PinToggle, IO_PinRead
+ * - Single pin versions of the functions above.
+ * @arg Pin is the pin number (0 to 15).
+ */
+inline void IO_PinSet(GPIO_TypeDef* Port, uint32_t Pin){ Port->BSRR = ((uint32_t)1 << Pin);}
+inline void IO_PinClear(GPIO_TypeDef* Port, uint32_t Pin){ Port->BRR = ((uint32_t)1 << Pin);}
+inline void IO_PinWrite(GPIO_TypeDef* Port, uint32_t Pin, bool Value){
+	Port->BSRR = ((uint32_t)1 << (Value? Pin : (Pin + 16)));
+}
+inline void IO_PinToggle(GPIO_TypeDef* Port, uint32_t Pin){ IO_Toggle(Port, ((uint32_t)1 << Pin));}
+inline bool IO_PinRead(GPIO_TypeDef* Port, uint32_t Pin){ return((Port->IDR >> Pin) & 1);}
+
+//------------------------------------------------------------------------------
 /**
  * @brief IO_GetExtendedIT
  * - Returns the Port:Pin numbers for a given "external interrupt" index
@@ -291,11 +375,22 @@ uint32_t IO_GetExtendedIT(uint32_t PinNumber);
 /**
  * @brief IO_SetExtendedIT
  * - Sets a given GPIO pin as "external interrupt" source
+ * @note Lines 5 to 9 and 10 to 15 share one vector each, which gets the
+ * highest priority among its enabled lines (see IO_SetExtendedPriority()).
  * @arg Port is the port "base-address" (i. e. GPIOA, GPIOB, etc)
  * @arg PinStruct is the pin configuration parameters structure as seen in @ref IO_Config.
  */
 void IO_SetExtendedIT(GPIO_TypeDef* Port, IO_Config* PinStruct);
 
+/**
+ * @brief IO_SetExtendedPriority
+ * - Sets the interrupt priority of an "external interrupt" line (the default
+ * is SYS_PRIORITY_NORMAL). May be called before or after IO_SetExtendedIT().
+ * @arg Line is the pin number (0 to 15)
+ * @arg Priority is a level as defined in @ref Priorities (i. e. SYS_PRIORITY_HIGH)
+ */
+void IO_SetExtendedPriority(uint32_t Line, uint32_t Priority);
+
 /**
  * @brief IO_ResetExtendedIT
  * - Clears the changes previously made to setup a given GPIO pin as "external interrupt" source
@@ -335,11 +430,25 @@ IRQn_Type IO_GetIrqNumber(uint32_t Pin);
 
 /**
  * @brief IO_PinConfig
- * - Sets the pinout configuration for the specified peripheral.
- * This function is now deprecated and should never be used in the application.
- * @arg ConfigId is the Peripheral:Pinout encoded value.
+ * - Sets the pinout configuration for the specified peripheral: its pins are
+ * configured with IO_PortConfig() (one batch per port) and its remap bits
+ * written to AFIO->MAPR in a single store.
+ * @arg ConfigId is the Peripheral:Pinout encoded value, i. e. __USART1_REMAPPED,
+ * __USART3_REMAPPED | __MASK_FULL (full remap), __SPI2_STANDARD | __MASK_SLAVE.
+ * @return false if ConfigId is unknown (or not available in this device).
+ * @note Pinouts on the JTAG pins (PA15, PB3, PB4) switch the debug port to
+ * SW-DP only, see IO_SetDebugPort().
+ */
+bool IO_PinConfig(uint16_t ConfigId);
+
+/**
+ * @brief IO_SetDebugPort
+ * - Sets the SWJ_CFG field of AFIO->MAPR. These bits are write-only, so the
+ * driver keeps a copy and every MAPR write goes through it: the application
+ * must use this function instead of writing the field directly.
+ * @arg SwjConfig is one of the AFIO_MAPR_SWJ_CFG_* values.
  */
-void IO_PinConfig(uint16_t ConfigId);
+void IO_SetDebugPort(uint32_t SwjConfig);
 
 /**
  * @}
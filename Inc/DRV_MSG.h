@@ -0,0 +1,139 @@
+//==============================================================================
+/** @file DRV_MSG.h
+ *  @brief Message Lanes Kernel Driver
+ *  Priority message queue made of one lock-free MPSC ring ("lane") per priority
+ *  class. NMESSAGEs can be posted from any interrupt level and are drained in
+ *  batches by the dispatcher, highest lane first. Each lane keeps high-water
+ *  and overflow counters, so the lane sizes can be tuned from field data.
+ *  @version 1.0.0
+ *  @author J. Nilo Rodrigues - nilo@pobox.com
+ *
+ *------------------------------------------------------------------------------
+ *
+ * <h2><center>&copy; Copyright (c) 2020 Joao Nilo Rodrigues </center></h2>
+ * <h2><center> All rights reserved. </center></h2>
+ *
+ * This software component is licensed by "Joao Nilo Rodrigues" under BSD 3-Clause
+ * license, the "License".
+ * You may not use this file except in compliance with the License.
+ *               You may obtain a copy of the License at:
+ *                 opensource.org/licenses/BSD-3-Clause
+ *
+ *///---------------------------------------------------------------------------
+#ifndef DRV_MSG_H
+    #define DRV_MSG_H
+
+	#include <stddef.h>
+	#include "GenericTypeDefs.h"
+	#include "DRV_RING.h"
+
+//------------------------------------------------------------------------------
+/**
+ * @def MSG_SIGNAL_SIZE
+ * - capacity of the signal lane (defaults to __SYS_MAX_SIGNALS, rounded up to a power of two)
+ * @def MSG_NORMAL_SIZE
+ * - capacity of the normal lane
+ * @def MSG_LOW_SIZE
+ * - capacity of the low priority lane
+ * @note All the lane sizes must be powers of two.
+ */
+#ifndef MSG_SIGNAL_SIZE
+	#define MSG_SIGNAL_SIZE			MSG_RoundUp(__SYS_MAX_SIGNALS)
+#endif
+
+#ifndef MSG_NORMAL_SIZE
+	#define MSG_NORMAL_SIZE			16
+#endif
+
+#ifndef MSG_LOW_SIZE
+	#define MSG_LOW_SIZE			8
+#endif
+
+#define MSG_LANE_SIGNAL				0			//!< high priority notifications (SSR_ThrowMessage)
+#define MSG_LANE_NORMAL				1			//!< regular notifications
+#define MSG_LANE_LOW				2			//!< background notifications
+#define MSG_LANES					3
+
+/**
+ * @if cond_macros
+ */
+constexpr uint32_t MSG_RoundUp(uint32_t n){
+	return((n <= 2)? 2 : (MSG_RoundUp((n + 1) >> 1) << 1));
+}
+/**
+ * @endif
+ */
+
+//------------------------------------------------------------------------------
+/**
+ * @brief Lane statistics.
+ */
+struct MSG_LaneStats{
+	uint32_t Capacity;					//!< lane size, in messages
+	uint32_t Pending;					//!< messages currently queued
+	uint32_t HighWater;					//!< highest number of queued messages seen
+	uint32_t Posted;					//!< messages accepted
+	uint32_t Overflows;					//!< messages rejected because the lane was full
+};
+
+/**
+ *  @defgroup DRV_MSG
+ *  @{
+ */
+
+//------------------------------------------------------------------------------
+/**
+ * @brief MSG_Post
+ * - Queues a message in the given lane.
+ * @arg Lane: MSG_LANE_SIGNAL, MSG_LANE_NORMAL or MSG_LANE_LOW
+ * @arg Message: the message to be queued (copied)
+ * @return false if the lane is full (the overflow counter is incremented).
+ * @note Lock-free: callable from any interrupt level and from the application.
+ */
+bool MSG_Post(uint32_t Lane, const NMESSAGE& Message);
+
+/**
+ * @brief MSG_Get
+ * - Removes the oldest message of the highest priority non-empty lane.
+ * @arg Message: receives the message
+ * @return false if all the lanes are empty.
+ * @note Single consumer: only the dispatcher may call MSG_Get() / MSG_Drain().
+ */
+bool MSG_Get(NMESSAGE& Message);
+
+/**
+ * @brief MSG_Drain
+ * - Removes up to Max messages at once, highest lane first.
+ * @arg Buffer: receives the messages, in dispatch order
+ * @arg Max: capacity of Buffer
+ * @return the number of messages removed.
+ */
+uint32_t MSG_Drain(NMESSAGE* Buffer, uint32_t Max);
+
+/**
+ * @brief MSG_IsEmpty
+ * @return true if no lane has pending messages.
+ */
+bool MSG_IsEmpty();
+
+/**
+ * @brief MSG_GetStats
+ * - Returns a snapshot of the counters of a lane.
+ * @arg Lane: the lane index
+ * @arg Stats: receives the counters
+ * @return false if Lane is out of range.
+ */
+bool MSG_GetStats(uint32_t Lane, MSG_LaneStats& Stats);
+
+/**
+ * @brief MSG_ClearStats
+ * - Clears the high-water, posted and overflow counters of all lanes.
+ */
+void MSG_ClearStats();
+
+/**
+ * @} // close group DRV_MSG
+ */
+
+#endif
+//==============================================================================
@@ -0,0 +1,147 @@
+//==============================================================================
+/** @file DRV_PIN.h
+ *  @brief Compile-time IO pins
+ *  Pin<Encoded> and PinGroup<Port, Mask> take the same __PORTx | __PINn
+ *  encoding as DRV_IO, but everything DRV_IO works out at run time (port
+ *  address, masks, CRL/CRH field, EXTI line, IRQn, clock enable bit) is a
+ *  constant here, so a write is a single store to an immediate address.
+ *  @version 1.0.0
+ *  @author J. Nilo Rodrigues - nilo@pobox.com
+ *
+ *------------------------------------------------------------------------------
+ *
+ * <h2><center>&copy; Copyright (c) 2020 Joao Nilo Rodrigues </center></h2>
+ * <h2><center> All rights reserved. </center></h2>
+ *
+ * This software component is licensed by "Joao Nilo Rodrigues" under BSD 3-Clause
+ * license, the "License".
+ * You may not use this file except in compliance with the License.
+ *               You may obtain a copy of the License at:
+ *                 opensource.org/licenses/BSD-3-Clause
+ *
+ *///---------------------------------------------------------------------------
+#ifndef DRV_PIN_H
+    #define DRV_PIN_H
+
+	#include "DRV_IO.h"
+
+//------------------------------------------------------------------------------
+/**
+ * @if cond_macros
+ */
+// 4-bit CRx field mask for every pin set in the low 8 bits of Mask
+constexpr uint32_t PIN_Fields(uint32_t Mask, uint32_t n = 0){
+	return((n == 8)? 0 : ((((Mask >> n) & 1)? ((uint32_t)IO_MASK_MODE << (n * IO_FIELD_MODE)) : 0) | PIN_Fields(Mask, n + 1)));
+}
+
+constexpr uint32_t PIN_Base(uint32_t PortIndex){
+	return((uint32_t)GPIOA_BASE + (PortIndex * GPIO_SIZE));
+}
+
+constexpr IRQn_Type PIN_IRQn(uint32_t Number){
+	return((Number < 5)? (IRQn_Type)(EXTI0_IRQn + Number) : (Number < 10)? EXTI9_5_IRQn : EXTI15_10_IRQn);
+}
+/**
+ * @endif
+ */
+
+/**
+ *  @defgroup DRV_PIN
+ *  @{
+ */
+
+//------------------------------------------------------------------------------
+/**
+ * @brief Pin
+ * - One GPIO pin, i. e. "typedef Pin<__PORTB | __PIN5> Led;" then "Led::Set();"
+ */
+template<uint16_t Encoded>
+struct Pin{
+	static_assert(Encoded != __NOTAV, "pin not available");
+	static_assert((Encoded & 0x00F0) == 0, "pin number must be 0 to 15");
+
+	static constexpr uint32_t PortIndex = (Encoded & __MASK_PIN) >> 8;		//!< 0: GPIOA, 1: GPIOB, etc
+	static constexpr uint32_t Number = Encoded & 0x000F;					//!< pin number (0 to 15)
+	static constexpr uint32_t Base = PIN_Base(PortIndex);					//!< port base-address
+	static constexpr uint32_t Mask = (uint32_t)1 << Number;					//!< pin mask (also the EXTI line)
+	static constexpr uint32_t ResetMask = Mask << 16;						//!< BSRR reset bit
+	static constexpr bool HighRegister = (Number > 7);						//!< mode field in CRH (else CRL)
+	static constexpr uint32_t ModeOffset = (Number & 0x07) * IO_FIELD_MODE;	//!< mode field position in CRx
+	static constexpr uint32_t ExtiLine = Mask;								//!< EXTI line bit
+	static constexpr uint32_t ExtiIndex = Number / 4;						//!< AFIO->EXTICR index
+	static constexpr uint32_t ExtiOffset = (Number % 4) * 4;				//!< port selector position in EXTICR
+	static constexpr IRQn_Type IRQn = PIN_IRQn(Number);						//!< EXTI interrupt number
+	static constexpr uint32_t ClockMask = RCC_APB2ENR_IOPAEN << PortIndex;	//!< RCC->APB2ENR bit
+
+	static GPIO_TypeDef* Port(){ return((GPIO_TypeDef*)Base);}
+
+	static void ClockOn(){ RCC->APB2ENR |= ClockMask;}
+	static void Set(){ Port()->BSRR = Mask;}
+	static void Clear(){ Port()->BRR = Mask;}
+	static void Write(bool Value){ Port()->BSRR = Value? Mask : ResetMask;}
+	static void Toggle(){ Port()->BSRR = (Port()->ODR & Mask)? ResetMask : Mask;}
+	static bool Read(){ return(Port()->IDR & Mask);}
+	static bool ReadOutput(){ return(Port()->ODR & Mask);}
+
+	/**
+	 * @brief Init
+	 * - Turns the port clock on and sets the pin mode (@ref io_modes); outputs
+	 * start low, pull-ups get their ODR bit set.
+	 */
+	static void Init(io_modes Mode){
+		uint32_t mode = (Mode == io_In_PullUp)? (uint32_t)io_In_PullDown : (uint32_t)Mode;
+		ClockOn();
+		Port()->BSRR = (Mode == io_In_PullUp)? Mask : ResetMask;
+		volatile uint32_t* cr = HighRegister? &Port()->CRH : &Port()->CRL;
+		*cr = (*cr & ~(IO_MASK_MODE << ModeOffset)) | (mode << ModeOffset);
+	}
+};
+
+//------------------------------------------------------------------------------
+/**
+ * @brief PinGroup
+ * - Several pins of one port, i. e. "typedef PinGroup<__PORTB, 0xFF00> Bus;"
+ * then "Bus::Write(x << 8);" (a single BSRR store).
+ */
+template<uint16_t PortEncoded, uint16_t PinMask>
+struct PinGroup{
+	static_assert(PortEncoded != __NOTAV, "port not available");
+	static_assert(PinMask != 0, "empty pin group");
+
+	static constexpr uint32_t PortIndex = (PortEncoded & __MASK_PIN) >> 8;	//!< 0: GPIOA, 1: GPIOB, etc
+	static constexpr uint32_t Base = PIN_Base(PortIndex);					//!< port base-address
+	static constexpr uint32_t Mask = PinMask;								//!< pin mask
+	static constexpr uint32_t LowFields = PIN_Fields(PinMask & 0xFF);		//!< mode fields in CRL
+	static constexpr uint32_t HighFields = PIN_Fields(PinMask >> 8);		//!< mode fields in CRH
+	static constexpr uint32_t ClockMask = RCC_APB2ENR_IOPAEN << PortIndex;	//!< RCC->APB2ENR bit
+
+	static GPIO_TypeDef* Port(){ return((GPIO_TypeDef*)Base);}
+
+	static void ClockOn(){ RCC->APB2ENR |= ClockMask;}
+	static void Set(){ Port()->BSRR = Mask;}
+	static void Clear(){ Port()->BRR = Mask;}
+	static void Write(uint32_t Value){ Port()->BSRR = (Value & Mask) | ((~Value & Mask) << 16);}
+	static void Toggle(){ uint32_t odr = Port()->ODR; Port()->BSRR = (~odr & Mask) | ((odr & Mask) << 16);}
+	static uint32_t Read(){ return(Port()->IDR & Mask);}
+	static uint32_t ReadOutput(){ return(Port()->ODR & Mask);}
+
+	/**
+	 * @brief Init
+	 * - Same as Pin::Init() for every pin of the group; each CRx register that
+	 * holds a pin of the group is written once.
+	 */
+	static void Init(io_modes Mode){
+		uint32_t mode = ((Mode == io_In_PullUp)? (uint32_t)io_In_PullDown : (uint32_t)Mode) * 0x11111111UL;
+		ClockOn();
+		Port()->BSRR = (Mode == io_In_PullUp)? Mask : (Mask << 16);
+		if(LowFields){ Port()->CRL = (Port()->CRL & ~LowFields) | (mode & LowFields);}
+		if(HighFields){ Port()->CRH = (Port()->CRH & ~HighFields) | (mode & HighFields);}
+	}
+};
+
+/**
+ * @} // close group DRV_PIN
+ */
+
+#endif
+//==============================================================================
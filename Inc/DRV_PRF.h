@@ -0,0 +1,143 @@
+//==============================================================================
+/** @file DRV_PRF.h
+ *  @brief IRQ Profiling Kernel Driver
+ *  Measures interrupt entry latency and handler duration with the DWT cycle
+ *  counter, keeping a log2 histogram per profiled vector.\n
+ *  The driver is only compiled in images built with SSR_PROFILE_IRQ, in which
+ *  case every handler installed through SSR_Allocate() is profiled.
+ *  @version 1.0.0
+ *  @author J. Nilo Rodrigues - nilo@pobox.com
+ *
+ *------------------------------------------------------------------------------
+ *
+ * <h2><center>&copy; Copyright (c) 2020 Joao Nilo Rodrigues </center></h2>
+ * <h2><center> All rights reserved. </center></h2>
+ *
+ * This software component is licensed by "Joao Nilo Rodrigues" under BSD 3-Clause
+ * license, the "License".
+ * You may not use this file except in compliance with the License.
+ *               You may obtain a copy of the License at:
+ *                 opensource.org/licenses/BSD-3-Clause
+ *
+ *///---------------------------------------------------------------------------
+#ifndef DRV_PRF_H
+    #define DRV_PRF_H
+
+#ifdef __cplusplus
+extern "C"{
+#endif
+
+	#include <stddef.h>
+	#include "stm32f1xx.h"
+	#include "DRV_SSR.h"
+
+//------------------------------------------------------------------------------
+/**
+ * @def PRF_MAX_SLOTS
+ * - number of vectors that can be profiled at the same time
+ * @def PRF_BINS
+ * - number of histogram bins (bin "b" counts samples below 2^(PRF_BIN_SHIFT + b) cycles,
+ * the last bin holds everything above)
+ */
+#ifndef PRF_MAX_SLOTS
+	#define PRF_MAX_SLOTS		16
+#endif
+
+#ifndef PRF_BINS
+	#define PRF_BINS			8
+#endif
+
+#ifndef PRF_BIN_SHIFT
+	#define PRF_BIN_SHIFT		5
+#endif
+
+#define PRF_NO_SLOT				((uint8_t) 0xFF)
+
+//------------------------------------------------------------------------------
+/**
+ * @brief Profiling data of a single vector.
+ * - All times are given in CPU cycles (DWT->CYCCNT).
+ */
+struct PRF_Stats{
+	uint32_t Vector;					//!< vector index (as given to SSR_Allocate)
+	uint32_t Isr;						//!< address of the profiled handler
+	volatile uint32_t Stamp;			//!< event timestamp set by PRF_Stamp() (0 if none)
+	uint32_t Count;						//!< number of handler executions
+	uint32_t Samples;					//!< number of latency samples
+	uint32_t LatencyMax;				//!< worst event-to-entry latency
+	uint32_t DurationMax;				//!< worst entry-to-exit duration
+	uint32_t Latency[PRF_BINS];			//!< latency histogram
+	uint32_t Duration[PRF_BINS];		//!< duration histogram
+};
+
+#ifdef __cplusplus
+}
+#endif
+
+/**
+ *  @defgroup DRV_PRF
+ *  @{
+ */
+
+//------------------------------------------------------------------------------
+/**
+ * @brief PRF_Initialize
+ * - Enables the DWT cycle counter and clears all the profiling data.
+ * @note Should be called before the first SSR_Allocate(). Called again, it
+ * keeps the vectors already wrapped (only their statistics are cleared).
+ */
+void PRF_Initialize();
+
+/**
+ * @brief PRF_Wrap
+ * - Registers a handler for profiling.
+ * @arg IsrAddress: the ISR function address
+ * @arg VectorIndex: the vector table position of this ISR
+ * @return the address to be written in the vector table (the profiler entry point),
+ * or IsrAddress itself if no profiling slot is available.
+ */
+uint32_t PRF_Wrap(uint32_t IsrAddress, uint32_t VectorIndex);
+
+/**
+ * @brief PRF_Stamp
+ * - Records the time of the hardware event that will fire the given vector.
+ * The next entry of that vector then produces a latency sample.
+ * @arg VectorIndex: the vector table position
+ */
+void PRF_Stamp(uint32_t VectorIndex);
+
+/**
+ * @brief PRF_Trigger
+ * - Stamps and software-pends an interrupt, measuring its entry latency under the
+ * current load. Useful to validate the SYS_PRIORITY_* assignments.
+ * @arg IRQn is the IRQ number to pend.
+ */
+void PRF_Trigger(IRQn_Type IRQn);
+
+/**
+ * @brief PRF_GetStats
+ * - Returns the profiling data of a given vector.
+ * @arg VectorIndex: the vector table position
+ * @return pointer to the data, or NULL if the vector is not being profiled.
+ */
+PRF_Stats* PRF_GetStats(uint32_t VectorIndex);
+
+/**
+ * @brief PRF_Clear
+ * - Clears all counters and histograms, keeping the registered handlers.
+ */
+void PRF_Clear();
+
+/**
+ * @brief PRF_Handler
+ * - Common entry point installed in the vector table for every profiled vector.
+ * @note Duration samples include the time spent in higher priority (nested) ISRs.
+ */
+extern "C" void PRF_Handler(void);
+
+/**
+ * @} // close group DRV_PRF
+ */
+
+#endif
+//==============================================================================
@@ -0,0 +1,117 @@
+//==============================================================================
+/** @file DRV_REG.h
+ *  @brief Component Registry Kernel Driver
+ *  Maps component addresses to compact handles (slot index + generation).
+ *  Resolving a handle is a single table access that also rejects stale handles,
+ *  and the reverse lookup (address to handle) goes through a small hash table,
+ *  so neither depends on the number of registered components.
+ *  @version 1.0.0
+ *  @author J. Nilo Rodrigues - nilo@pobox.com
+ *
+ *------------------------------------------------------------------------------
+ *
+ * <h2><center>&copy; Copyright (c) 2020 Joao Nilo Rodrigues </center></h2>
+ * <h2><center> All rights reserved. </center></h2>
+ *
+ * This software component is licensed by "Joao Nilo Rodrigues" under BSD 3-Clause
+ * license, the "License".
+ * You may not use this file except in compliance with the License.
+ *               You may obtain a copy of the License at:
+ *                 opensource.org/licenses/BSD-3-Clause
+ *
+ *///---------------------------------------------------------------------------
+#ifndef DRV_REG_H
+    #define DRV_REG_H
+
+	#include <stddef.h>
+	#include "GenericTypeDefs.h"
+
+//------------------------------------------------------------------------------
+/**
+ * @def REG_CAPACITY
+ * - maximum number of registered components (defaults to __SYS_MAX_OBJECTS)
+ */
+#ifndef REG_CAPACITY
+	#define REG_CAPACITY			__SYS_MAX_OBJECTS
+#endif
+
+#define REG_INVALID					((uint32_t) 0x00000000)
+
+/**
+ * @if cond_macros
+ */
+#define REG_NONE					((uint16_t) 0xFFFF)
+#define REG_INDEX_MASK				((uint32_t) 0x0000FFFF)
+#define REG_GENERATION_SHIFT		16
+/**
+ * @endif
+ */
+
+/**
+ *  @defgroup DRV_REG
+ *  @{
+ */
+
+//------------------------------------------------------------------------------
+/**
+ * @brief REG_Initialize
+ * - Empties the registry. Every handle given out before goes stale.
+ * @note The first REG_Register() calls it if it was not called before;
+ * until then REG_Find() finds nothing.
+ */
+void REG_Initialize();
+
+/**
+ * @brief REG_Register
+ * - Registers a component address.
+ * @arg Address: the component address (as given to SSR_IncludeComponent)
+ * @return the component handle (the existing one if the address is already
+ * registered), or REG_INVALID if the registry is full.
+ */
+uint32_t REG_Register(uint32_t Address);
+
+/**
+ * @brief REG_Unregister
+ * - Releases a handle. Every copy of it becomes stale.
+ * @arg Handle: the component handle
+ * @return false if the handle was already stale.
+ */
+bool REG_Unregister(uint32_t Handle);
+
+/**
+ * @brief REG_Resolve
+ * - Returns the address behind a handle, in constant time.
+ * @arg Handle: the component handle
+ * @return the component address, or NULL if the handle is stale.
+ */
+uint32_t REG_Resolve(uint32_t Handle);
+
+/**
+ * @brief REG_Find
+ * - Looks up the handle of a registered address (SVC_FIND_COMPONENT).
+ * @arg Address: the component address
+ * @return the component handle, or REG_INVALID if not registered.
+ */
+uint32_t REG_Find(uint32_t Address);
+
+/**
+ * @brief REG_GetIndex
+ * - Returns the slot index of a handle (0 .. REG_CAPACITY-1), which can be
+ * used to index per-component tables (notifications, callbacks, etc).
+ * @arg Handle: the component handle
+ * @return the slot index, or REG_CAPACITY if the handle is stale.
+ */
+uint32_t REG_GetIndex(uint32_t Handle);
+
+/**
+ * @brief REG_Count
+ * @return the number of registered components.
+ */
+uint32_t REG_Count();
+
+/**
+ * @} // close group DRV_REG
+ */
+
+#endif
+//==============================================================================
@@ -0,0 +1,197 @@
+//==============================================================================
+/** @file DRV_RING.h
+ *  @brief Lock-free Ring Buffers Kernel Driver
+ *  Header-only SPSC and MPSC ring buffer templates, used to hand data from
+ *  interrupt handlers to the application (or between interrupt levels)
+ *  without disabling interrupts.
+ *  @version 1.0.0
+ *  @author J. Nilo Rodrigues - nilo@pobox.com
+ *
+ *------------------------------------------------------------------------------
+ *
+ * <h2><center>&copy; Copyright (c) 2020 Joao Nilo Rodrigues </center></h2>
+ * <h2><center> All rights reserved. </center></h2>
+ *
+ * This software component is licensed by "Joao Nilo Rodrigues" under BSD 3-Clause
+ * license, the "License".
+ * You may not use this file except in compliance with the License.
+ *               You may obtain a copy of the License at:
+ *                 opensource.org/licenses/BSD-3-Clause
+ *
+ *///---------------------------------------------------------------------------
+#ifndef DRV_RING_H
+    #define DRV_RING_H
+
+	#include "GenericTypeDefs.h"
+
+//------------------------------------------------------------------------------
+/**
+ * @if cond_macros
+ */
+#if defined(__arm__)
+	#include "stm32f1xx.h"
+
+	typedef volatile uint32_t RING_Index;
+
+	inline uint32_t RING_Load(RING_Index* p){ return(*p);}
+	inline void RING_Store(RING_Index* p, uint32_t v){ *p = v;}
+	inline uint32_t RING_LoadExclusive(RING_Index* p){ return(__LDREXW(p));}
+	inline bool RING_StoreExclusive(RING_Index* p, uint32_t, uint32_t v){ return(__STREXW(v, p) == 0);}
+	inline void RING_ClearExclusive(){ __CLREX();}
+	inline void RING_Barrier(){ __DMB();}
+
+#else
+	// host build: the exclusive pair is emulated by a compare-and-swap
+	#include <atomic>
+
+	typedef std::atomic<uint32_t> RING_Index;
+
+	inline uint32_t RING_Load(RING_Index* p){ return(p->load(std::memory_order_acquire));}
+	inline void RING_Store(RING_Index* p, uint32_t v){ p->store(v, std::memory_order_release);}
+	inline uint32_t RING_LoadExclusive(RING_Index* p){ return(p->load(std::memory_order_acquire));}
+	inline bool RING_StoreExclusive(RING_Index* p, uint32_t loaded, uint32_t v){
+		return(p->compare_exchange_weak(loaded, v, std::memory_order_acq_rel));
+	}
+	inline void RING_ClearExclusive(){}
+	inline void RING_Barrier(){ std::atomic_thread_fence(std::memory_order_seq_cst);}
+#endif
+/**
+ * @endif
+ */
+
+/**
+ *  @defgroup DRV_RING
+ *  @{
+ */
+
+//------------------------------------------------------------------------------
+/**
+ * @brief SpscRing
+ * - Single-producer / single-consumer ring buffer.
+ * @arg T is the element type (i. e. NMESSAGE, uint8_t, etc)
+ * @arg N is the capacity in elements (must be a power of two)
+ * @note The producer and the consumer may run at different interrupt levels,
+ * as long as each side is owned by one context only.
+ */
+template <typename T, uint32_t N>
+class SpscRing{
+	static_assert((N >= 2) && ((N & (N - 1)) == 0), "ring capacity must be a power of two");
+
+	private:
+		RING_Index head;		// written by the producer only
+		RING_Index tail;		// written by the consumer only
+		T buffer[N];
+
+	public:
+		SpscRing(){ RING_Store(&head, 0); RING_Store(&tail, 0);}
+
+		//----------------------------------------------------------------------
+		bool Push(const T& item){
+			uint32_t h = RING_Load(&head);
+			if((h - RING_Load(&tail)) >= N){ return(false);}
+			buffer[h & (N - 1)] = item;
+			RING_Barrier();
+			RING_Store(&head, h + 1);
+			return(true);
+		}
+
+		//----------------------------------------------------------------------
+		bool Pop(T& item){
+			uint32_t t = RING_Load(&tail);
+			if(t == RING_Load(&head)){ return(false);}
+			RING_Barrier();
+			item = buffer[t & (N - 1)];
+			RING_Barrier();
+			RING_Store(&tail, t + 1);
+			return(true);
+		}
+
+		//----------------------------------------------------------------------
+		uint32_t Count(){ return(RING_Load(&head) - RING_Load(&tail));}
+		bool IsEmpty(){ return(Count() == 0);}
+		bool IsFull(){ return(Count() >= N);}
+		static constexpr uint32_t Capacity(){ return(N);}
+};
+
+//------------------------------------------------------------------------------
+/**
+ * @brief MpscRing
+ * - Multi-producer / single-consumer ring buffer.
+ * The producers reserve their slots with LDREX/STREX, so Push() can be called
+ * from any number of interrupt levels (and from the application) at once.
+ * @arg T is the element type (i. e. NMESSAGE, uint8_t, etc)
+ * @arg N is the capacity in elements (must be a power of two)
+ * @note Each slot carries a sequence word, so a producer preempted between
+ * reserving and filling its slot never exposes a half-written element: the
+ * consumer simply sees the ring as empty until that slot is published.
+ */
+template <typename T, uint32_t N>
+class MpscRing{
+	static_assert((N >= 2) && ((N & (N - 1)) == 0), "ring capacity must be a power of two");
+
+	private:
+		struct Slot{
+			RING_Index sequence;
+			T data;
+		};
+
+		RING_Index head;		// shared by the producers
+		RING_Index tail;		// written by the consumer only
+		Slot slots[N];
+
+	public:
+		MpscRing(){
+			RING_Store(&head, 0);
+			RING_Store(&tail, 0);
+			for(uint32_t i=0; i<N; i++){ RING_Store(&slots[i].sequence, i);}
+		}
+
+		//----------------------------------------------------------------------
+		bool Push(const T& item){
+			uint32_t h;
+			Slot* slot;
+
+			while(true){
+				h = RING_LoadExclusive(&head);
+				slot = &slots[h & (N - 1)];
+				int32_t lag = (int32_t)(RING_Load(&slot->sequence) - h);
+				if(lag == 0){
+					if(RING_StoreExclusive(&head, h, h + 1)){ break;}
+				} else {
+					RING_ClearExclusive();
+					if(lag < 0){ return(false);}		// ring is full
+				}
+			}
+
+			slot->data = item;
+			RING_Barrier();
+			RING_Store(&slot->sequence, h + 1);
+			return(true);
+		}
+
+		//----------------------------------------------------------------------
+		bool Pop(T& item){
+			uint32_t t = RING_Load(&tail);
+			Slot* slot = &slots[t & (N - 1)];
+			if(RING_Load(&slot->sequence) != (t + 1)){ return(false);}
+			RING_Barrier();
+			item = slot->data;
+			RING_Barrier();
+			RING_Store(&slot->sequence, t + N);
+			RING_Store(&tail, t + 1);
+			return(true);
+		}
+
+		//----------------------------------------------------------------------
+		// number of reserved slots (includes slots still being written)
+		uint32_t Count(){ return(RING_Load(&head) - RING_Load(&tail));}
+		bool IsEmpty(){ return(Count() == 0);}
+		static constexpr uint32_t Capacity(){ return(N);}
+};
+
+/**
+ * @} // close group DRV_RING
+ */
+
+#endif
+//==============================================================================
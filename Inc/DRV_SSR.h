@@ -24,6 +24,7 @@
 extern "C"{
 #endif
 
+	#include <stddef.h>
 	#include "stm32f1xx.h"
     #include <SysExceptions.h>
 
@@ -48,6 +49,93 @@ extern "C"{
 	#define SVC_MICROSECONDS				((uint8_t) 0x12)
 	#define SVC_DELAY						((uint8_t) 0x13)
 	#define SVC_MICRODELAY					((uint8_t) 0x14)
+	#define SVC_BATCH						((uint8_t) 0x15)
+	#define SVC_ARM_TIMEOUT					((uint8_t) 0x16)
+	#define SVC_CANCEL_TIMEOUT				((uint8_t) 0x17)
+	#define SVC_RESCHEDULE_TIMEOUT			((uint8_t) 0x18)
+
+	#define SSR_RESULT_INVALID				((uint32_t) 0xFFFFFFFF)
+
+	//--------------------------------------------------------------------------
+	/**
+	 * @def SSR_SERVICE_LIST
+	 * - The one list of system services: X(number, name).
+	 * It generates the kernel dispatch table (indexed by the SVC immediate), the
+	 * SSR_Service_<name>() handler prototypes and the immediate of each SVC stub
+	 * (looked up by name), so the three cannot drift apart.
+	 */
+	#define SSR_SERVICE_LIST(X)									\
+		X(SVC_RELOCATE_VECTORS,		RelocateVectors)			\
+		X(SVC_INCLUDE_COMPONENT,	IncludeComponent)			\
+		X(SVC_EXCLUDE_COMPONENT,	ExcludeComponent)			\
+		X(SVC_INSTALL_CALLBACK,		InstallCallback)			\
+		X(SVC_FIND_COMPONENT,		FindComponent)				\
+		X(SVC_GET_CALLBACK,			GetCallback)				\
+		X(SVC_GET_SYSTEM_TIME,		GetSystemTime)				\
+		X(SVC_INSTALL_TIMEOUT,		InstallTimeout)				\
+		X(SVC_GET_KS_CODE,			GetKSCode)					\
+		X(SVC_GET_CALLBACK_VECTOR,	GetCallbackVector)			\
+		X(SVC_THROW_MESSAGE,		ThrowMessage)				\
+		X(SVC_THROW_EXCEPTION,		ThrowException)				\
+		X(SVC_MICROSECONDS,			Microseconds)				\
+		X(SVC_DELAY,				Delay)						\
+		X(SVC_MICRODELAY,			MicroDelay)					\
+		X(SVC_BATCH,				Batch)						\
+		X(SVC_ARM_TIMEOUT,			ArmTimeout)					\
+		X(SVC_CANCEL_TIMEOUT,		CancelTimeout)				\
+		X(SVC_RESCHEDULE_TIMEOUT,	RescheduleTimeout)
+
+	//--------------------------------------------------------------------------
+	// the RAM table must be aligned to its size rounded up to a power of two
+	#if defined(STM32F105xC) || defined(STM32F107xC)
+		#define SSR_MAX_VECTORS				84
+		#define SSR_VECTORS_ALIGN			512
+	#elif defined(STM32F103x6) || defined(STM32F103xB)
+		#define SSR_MAX_VECTORS				59
+		#define SSR_VECTORS_ALIGN			256
+	#else
+		#define SSR_MAX_VECTORS				76
+		#define SSR_VECTORS_ALIGN			512
+	#endif
+
+	/**
+	 * @def SSR_FLASH_VECTORS
+	 * - when defined, the vector table is a constant table in flash, generated at
+	 * compile time from the SSR_FLASH_HANDLERS(X) list, i. e. X(NV_UART1, Uart1_Isr),
+	 * which the application provides in "SsrVectors.h". SSR_Relocate() then just
+	 * points VTOR to it and no RAM is reserved. SSR_Allocate() only checks that the
+	 * table holds the same handler, and faults (breakpoint) otherwise.
+	 * @note Context-taking handlers still work: list SSR_Trampoline for the vector
+	 * and bind the context with SSR_AllocateContext().
+	 *
+	 * @def SSR_RELOCATE_DMA
+	 * - when defined (as a DMA1 channel, i. e. DMA1_Channel1), SSR_Relocate()
+	 * copies the vector table by DMA (polled) instead of the CPU.
+	 *
+	 * @def SSR_DIRECT_TIME
+	 * - when defined, SSR_GetSystemTime(), SSR_Microseconds() and SSR_GetKSCode()
+	 * read the shared time block directly instead of trapping into the kernel.
+	 * @note The kernel must then call SSR_PublishTime() on every SysTick (and
+	 * SSR_PublishKSCode()), otherwise the time reads as 0. Without it the
+	 * trapped services read the same block, unless the kernel overrides them.
+	 */
+
+	#define SSR_VECTOR(IRQn)				((uint32_t)(IRQn) + 16)
+
+	//--------------------------------------------------------------------------
+	/**
+	 * @brief System service request record, as used by SSR_Batch().
+	 * - SSR_Batch(List, N) executes N records in a single SVC exception and
+	 * writes each Result back, returning the number of records executed.
+	 * @note The whole list runs inside the SVC handler, so no other thread-level
+	 * code (nor ISRs at or below the SVC priority) sees a partial registration.
+	 * @note SVC_BATCH records are not allowed inside a batch.
+	 */
+	struct SSR_Request{
+		uint32_t Service;				//!< service number (SVC_INCLUDE_COMPONENT, SVC_INSTALL_CALLBACK, etc)
+		uint32_t Args[4];				//!< service arguments, in the same order as the SSR_* call
+		uint32_t Result;				//!< service return value (SSR_RESULT_INVALID if rejected)
+	};
 
 	//--------------------------------------------------------------------------
 	/**
@@ -56,7 +144,24 @@ extern "C"{
 	 */
 
 	//--------------------------------------------------------------------------
-	#if defined(__GNUC__)
+	#if defined(SSR_HOST)
+		// host backend (Host/SSR_Host.cpp): the services are plain function calls
+		void SSR_IncludeComponent(uint32_t hComp);
+		void SSR_ExcludeComponent(uint32_t hComp);
+		uint32_t SSR_InstallCallback(uint32_t, uint32_t);
+		uint32_t SSR_GetCallback(uint32_t);
+		bool SSR_InstallTimeout(uint32_t, uint32_t);
+		uint32_t SSR_GetCallbackVector(uint32_t);
+		void SSR_ThrowMessage(uint32_t, uint32_t, uint32_t, uint32_t);
+		void SSR_ThrowException(uint32_t);
+		uint32_t SSR_Delay(uint32_t);
+		uint32_t SSR_MicroDelay(uint32_t);
+		uint32_t SSR_Batch(SSR_Request*, uint32_t);
+		uint32_t SSR_ArmTimeout(uint32_t, uint32_t);
+		bool SSR_CancelTimeout(uint32_t);
+		bool SSR_RescheduleTimeout(uint32_t, uint32_t);
+
+	#elif defined(__GNUC__)
 		#define __svc							__attribute__((naked)) __attribute__((noinline))
 
 		//void __attribute__((naked)) __attribute__((noinline)) SSR_IncludeComponent(uint32_t hComp);
@@ -67,53 +172,339 @@ extern "C"{
 
 		uint32_t __attribute__((naked)) __attribute__((noinline)) SSR_InstallCallback(uint32_t, uint32_t);
 		uint32_t __attribute__((naked)) __attribute__((noinline)) SSR_GetCallback(uint32_t);
-		uint32_t __attribute__((naked)) __attribute__((noinline)) SSR_GetSystemTime(void);
 		bool __attribute__((naked)) __attribute__((noinline)) SSR_InstallTimeout(uint32_t, uint32_t);
-		uint32_t __attribute__((naked)) __attribute__((noinline)) SSR_GetKSCode(void);
 		uint32_t __attribute__((naked)) __attribute__((noinline)) SSR_GetCallbackVector(uint32_t);
 		void __attribute__((naked)) __attribute__((noinline)) SSR_ThrowMessage(uint32_t, uint32_t, uint32_t, uint32_t);
 		void __attribute__((naked)) __attribute__((noinline)) SSR_ThrowException(uint32_t);
-		uint32_t __attribute__((naked)) __attribute__((noinline)) SSR_Microseconds();
 		uint32_t __attribute__((naked)) __attribute__((noinline)) SSR_Delay(uint32_t);
 		uint32_t __attribute__((naked)) __attribute__((noinline)) SSR_MicroDelay(uint32_t);
+		uint32_t __attribute__((naked)) __attribute__((noinline)) SSR_Batch(SSR_Request*, uint32_t);
+		uint32_t __attribute__((naked)) __attribute__((noinline)) SSR_ArmTimeout(uint32_t, uint32_t);
+		bool __attribute__((naked)) __attribute__((noinline)) SSR_CancelTimeout(uint32_t);
+		bool __attribute__((naked)) __attribute__((noinline)) SSR_RescheduleTimeout(uint32_t, uint32_t);
 
     #elif defined(__ICCARM__)
 		__irq void SSR_IncludeComponent(uint32_t);
 		__irq void SSR_ExcludeComponent(uint32_t);
 		__irq uint32_t SSR_InstallCallback(uint32_t, uint32_t);
 		__irq uint32_t SSR_GetCallback(uint32_t);
-		__irq uint32_t SSR_GetSystemTime(void);
 		__irq bool SSR_InstallTimeout(uint32_t, uint32_t);
-		__irq uint32_t SSR_GetKSCode(void);
 		__irq uint32_t SSR_GetCallbackVector(uint32_t);
 		__irq void SSR_ThrowMessage(uint32_t, uint32_t, uint32_t, uint32_t);
 		__irq void SSR_ThrowException(uint32_t);
+		__irq uint32_t SSR_Batch(SSR_Request*, uint32_t);
+		__irq uint32_t SSR_ArmTimeout(uint32_t, uint32_t);
+		__irq bool SSR_CancelTimeout(uint32_t);
+		__irq bool SSR_RescheduleTimeout(uint32_t, uint32_t);
     #endif
 
+	//--------------------------------------------------------------------------
+	// time services: trapped (SVC) unless SSR_DIRECT_TIME is defined
+	#if !defined(SSR_DIRECT_TIME) && !defined(SSR_HOST)
+		#if defined(__GNUC__)
+			uint32_t __attribute__((naked)) __attribute__((noinline)) SSR_GetSystemTime(void);
+			uint32_t __attribute__((naked)) __attribute__((noinline)) SSR_GetKSCode(void);
+			uint32_t __attribute__((naked)) __attribute__((noinline)) SSR_Microseconds();
+		#elif defined(__ICCARM__)
+			__irq uint32_t SSR_GetSystemTime(void);
+			__irq uint32_t SSR_GetKSCode(void);
+			__irq uint32_t SSR_Microseconds(void);
+		#endif
+	#else
+		uint32_t SSR_GetSystemTime(void);
+		uint32_t SSR_GetKSCode(void);
+		uint32_t SSR_Microseconds(void);
+	#endif
+
+	//--------------------------------------------------------------------------
+	/**
+	 * @brief Shared time block.
+	 * - Published by the kernel (SysTick) and read by SSR_GetSystemTime(),
+	 * SSR_Microseconds() and SSR_GetKSCode() without trapping into the kernel
+	 * when SSR_DIRECT_TIME is defined.
+	 * @note Sequence is odd while an update is in progress (seqlock).
+	 */
+	struct SSR_TimeBlock{
+		volatile uint32_t Sequence;		//!< update counter (odd while writing)
+		volatile uint32_t Milliseconds;	//!< system time, in kernel ticks (1 ms)
+		volatile uint32_t KSCode;		//!< kernel status code
+	};
+
 	//--------------------------------------------------------------------------
 	/**
 	 * @brief SSR_Relocate
 	 * - Relocates the ISR vector table.
-	 * @arg nVectors: the size of vector table to relocate
-	 * @note  1 - The relocation defaults to 0x20000000 in RAM.
-	 * @note  2 - Make sure to allocate enough space in this position before relocating the vector table.
+	 * @arg nVectors: the size of vector table to relocate (up to SSR_MAX_VECTORS)
+	 * @note  1 - The table is copied from the current VTOR to a SSR_VECTORS_ALIGN
+	 * aligned array in the ".bss.ram_vectors" section, so the linker reserves it
+	 * (any "*(.bss*)" rule picks it up).
+	 * @note  2 - Built with SSR_RELOCATE_DMA the copy is done by DMA (32-bit words,
+	 * polled, no channel interrupt); if the channel is busy or the transfer fails
+	 * the CPU copies the table.
 	 */
 	void  SSR_Relocate(int nVectors);
 
+	/**
+	 * @brief SSR_GetVectorTable
+	 * @return the vector table used by SSR_Relocate() and SSR_Allocate()
+	 * (the constant flash table with SSR_FLASH_VECTORS).
+	 */
+	uint32_t* SSR_GetVectorTable(void);
+
 	/**
 	 * @brief SSR_Allocate
 	 * - Allocates a particular ISR function handler in the vector table.
 	 * @arg IsrAddress: the ISR function address
 	 * @arg VectorIndex is the IRQ number for this ISR function.
+	 * @note VectorIndex is the position in the vector table (exception number),
+	 * which is SSR_VECTOR(IRQn) for peripheral interrupts.
+	 * @note When built with SSR_PROFILE_IRQ the handler is wrapped by the
+	 * IRQ profiler (see @ref DRV_PRF).
+	 * @note When built with SSR_FLASH_VECTORS nothing is written: the handler
+	 * must already be in SSR_FLASH_HANDLERS for that vector (the drivers that
+	 * install their own handlers, i. e. EXT_Handler() or DLY_Handler(), too),
+	 * otherwise a breakpoint is raised.
 	 */
 	void SSR_Allocate(uint32_t IsrAddress, uint32_t VectorIndex);
 
+	//--------------------------------------------------------------------------
+	/**
+	 * @brief Context-taking interrupt handler, as installed by SSR_AllocateContext().
+	 * @arg Context: the context pointer bound to the vector (usually "this")
+	 */
+	typedef void (*SSR_ContextHandler)(void* Context);
+
+	/**
+	 * @brief SSR_AllocateContext
+	 * - Allocates a context-taking handler in the vector table. The vector points
+	 * to SSR_Trampoline(), which fetches the handler and its context from a table
+	 * indexed by the active vector (IPSR) and tail-calls the handler.
+	 * @arg Handler: the handler function
+	 * @arg Context: the pointer passed to Handler on every interrupt
+	 * @arg VectorIndex: the position in the vector table (SSR_VECTOR(IRQn))
+	 * @note See SSR_AllocateMember() to bind a member function directly.
+	 */
+	void SSR_AllocateContext(SSR_ContextHandler Handler, void* Context, uint32_t VectorIndex);
+
+	/**
+	 * @brief SSR_GetContext
+	 * @arg VectorIndex: the position in the vector table
+	 * @return the context bound to the vector, or NULL if none.
+	 */
+	void* SSR_GetContext(uint32_t VectorIndex);
+
+	/**
+	 * @brief SSR_Trampoline
+	 * - Common entry point of the context-taking handlers. Its whole overhead
+	 * is one IPSR read, one table load and a tail call.
+	 */
+	void SSR_Trampoline(void);
+
+	/**
+	 * @brief SSR_ExecuteBatch
+	 * - Kernel side of SVC_BATCH: runs each record through SSR_Execute().
+	 * Called by the SVC handler with the stacked r0/r1 of the caller.
+	 * @arg List: array of service requests
+	 * @arg N: number of records in List
+	 * @return the number of records executed.
+	 */
+	uint32_t SSR_ExecuteBatch(SSR_Request* List, uint32_t N);
+
+	/**
+	 * @brief SSR_Execute
+	 * - Executes a single service from within the SVC handler, through the
+	 * constant dispatch table generated from SSR_SERVICE_LIST.
+	 * @arg Service: the service number (SVC_*)
+	 * @arg Args: the service arguments (stacked r0..r3)
+	 * @return the service return value (SSR_RESULT_INVALID for unknown services).
+	 */
+	uint32_t SSR_Execute(uint8_t Service, uint32_t* Args);
+
+	/**
+	 * @brief SSR_Dispatch
+	 * - Decodes the SVC immediate from the stacked PC and executes the service,
+	 * writing its result back to the stacked r0.
+	 * @arg Frame: the exception stack frame (MSP or PSP, as selected by EXC_RETURN).
+	 * @note To be called (or branched to) from the kernel's SVC_Handler.
+	 */
+	void SSR_Dispatch(uint32_t* Frame);
+
+	//--------------------------------------------------------------------------
+	/**
+	 * @brief Service handlers
+	 * - One SSR_Service_<name>(Args) per SSR_SERVICE_LIST entry. GetSystemTime,
+	 * GetKSCode, Microseconds, Batch, ThrowMessage, the timeout services and the
+	 * component services (Include, Exclude and FindComponent, on @ref DRV_REG)
+	 * are implemented by this driver, the remaining ones by the kernel.
+	 * @note The component services are weak: a kernel keeping its own list
+	 * defines them instead. ExcludeComponent also cancels the component's
+	 * SSR_InstallTimeout() timeout.
+	 * @note GetSystemTime, GetKSCode and Microseconds are weak and read the
+	 * time block, so they need SSR_PublishTime() (and SSR_PublishKSCode()) on
+	 * every SysTick; a kernel keeping its own time defines them instead.
+	 * @note The kernel services have weak defaults, so the driver links without
+	 * a kernel; they trap (breakpoint) when called, so a missing service is not
+	 * taken for a failed one. A kernel in a library must then be pulled in by
+	 * some other symbol, the weak default does not pull it.
+	 * @note ThrowMessage posts to the MSG_LANE_SIGNAL lane (see @ref DRV_MSG);
+	 * interrupt handlers should call MSG_Post() directly instead of trapping.
+	 */
+	typedef uint32_t (*SSR_ServiceHandler)(uint32_t* Args);
+
+	#define SSR_SERVICE_PROTOTYPE(Number, Name)		uint32_t SSR_Service_##Name(uint32_t* Args);
+	SSR_SERVICE_LIST(SSR_SERVICE_PROTOTYPE)
+
+	//--------------------------------------------------------------------------
+	/**
+	 * @brief SSR_NotifyTimeout
+	 * - Kernel hook called (from the SysTick context) when a timeout armed by
+	 * SSR_InstallTimeout() or SSR_ArmTimeout() expires.
+	 * @arg hComp: the component handle given when arming
+	 * @arg Handle: the timeout handle (see @ref DRV_TMW)
+	 * @note The timeouts run on the timing wheel, so the kernel SysTick must
+	 * call TMW_Tick() once per millisecond.
+	 * @note SSR_InstallTimeout() keeps one timeout per component: installing it
+	 * again before it expires reschedules the same timer (no new one is armed).
+	 * The component is registered (see @ref DRV_REG) if it was not, so up to
+	 * __SYS_MAX_OBJECTS components hold one at the same time.
+	 * SSR_ArmTimeout() arms a new timer on every call.
+	 * @note SSR_CancelTimeout() takes either the handle returned by
+	 * SSR_ArmTimeout() or a component handle, which cancels the timeout
+	 * installed by that component (a registered component takes precedence).
+	 * @note The driver provides an empty weak default (the timeouts are lost).
+	 */
+	void SSR_NotifyTimeout(uint32_t hComp, uint32_t Handle);
+
+	//--------------------------------------------------------------------------
+	/**
+	 * @brief Per-service statistics (only with SSR_SERVICE_STATS).
+	 */
+	struct SSR_ServiceStats{
+		uint32_t Calls;					//!< number of invocations
+		uint32_t Cycles;				//!< total cycles spent in the handler (DWT->CYCCNT)
+	};
+
+	/**
+	 * @brief SSR_GetServiceStats
+	 * - Returns the invocation counter and cycle total of a given service.
+	 * @arg Service: the service number (SVC_*)
+	 * @return pointer to the statistics, or NULL if not available.
+	 */
+	const SSR_ServiceStats* SSR_GetServiceStats(uint8_t Service);
+
+	/**
+	 * @brief SSR_ClearServiceStats
+	 * - Clears all the service statistics and starts the DWT cycle counter.
+	 */
+	void SSR_ClearServiceStats(void);
+
+	/**
+	 * @brief SSR_PublishTime
+	 * - Updates the shared time block. Called by the kernel on every SysTick,
+	 * unless it overrides the time services (see Service handlers).
+	 * @arg Milliseconds: the new system time.
+	 */
+	void SSR_PublishTime(uint32_t Milliseconds);
+
+	/**
+	 * @brief SSR_PublishKSCode
+	 * - Updates the kernel status code in the shared time block.
+	 * @arg KSCode: the new kernel status code.
+	 */
+	void SSR_PublishKSCode(uint32_t KSCode);
+
+	/**
+	 * @brief SSR_GetTimeBlock
+	 * - Returns the (read-only) shared time block.
+	 */
+	const SSR_TimeBlock* SSR_GetTimeBlock(void);
+
 /*
  * @}
  */
 
 #ifdef __cplusplus
 }
+
+//------------------------------------------------------------------------------
+// the header may itself be included from an extern "C" block
+extern "C++" {
+
+/**
+ * @brief SSR_NVToIRQn
+ * - Maps a framework vector index (NV_ID, see Priorities.h) to its IRQ number.
+ * @arg nv: the NV_ID value
+ * @return the IRQ number, or -1 if the peripheral has no vector on this device.
+ * @note Shared vectors (EXTI9_5, EXTI15_10, ADC1_2, USB/CAN1) map several NV_IDs
+ * to the same IRQ number.
+ */
+constexpr int32_t SSR_NVToIRQn(uint32_t nv){
+	if(nv <= 0x04){ return((int32_t)EXTI0_IRQn + (int32_t)nv);}
+	if(nv <= 0x09){ return(EXTI9_5_IRQn);}
+	if(nv <= 0x0F){ return(EXTI15_10_IRQn);}
+	if(nv <= 0x16){ return((int32_t)DMA1_Channel1_IRQn + (int32_t)(nv - 0x10));}
+	switch(nv){
+		case 0x1C: return(TIM1_UP_IRQn);
+		case 0x1D: return(TIM2_IRQn);
+		case 0x1E: return(TIM3_IRQn);
+		case 0x1F: return(TIM4_IRQn);
+		case 0x24: return(I2C1_EV_IRQn);
+		case 0x25: return(I2C2_EV_IRQn);
+		case 0x26: return(SPI1_IRQn);
+		case 0x27: return(SPI2_IRQn);
+		case 0x29: return(USART1_IRQn);
+		case 0x2A: return(USART2_IRQn);
+		case 0x2B: return(USART3_IRQn);
+		case 0x32: return(ADC1_2_IRQn);
+		case 0x33: return(ADC1_2_IRQn);
+		case 0x35: return(RTC_IRQn);
+		#if defined(STM32F105xC) || defined(STM32F107xC)
+		case 0x17: return(DMA2_Channel1_IRQn);
+		case 0x18: return(DMA2_Channel2_IRQn);
+		case 0x19: return(DMA2_Channel3_IRQn);
+		case 0x1A: return(DMA2_Channel4_IRQn);
+		case 0x1B: return(DMA2_Channel5_IRQn);
+		case 0x20: return(TIM5_IRQn);
+		case 0x21: return(TIM6_IRQn);
+		case 0x22: return(TIM7_IRQn);
+		case 0x28: return(SPI3_IRQn);
+		case 0x2C: return(UART4_IRQn);
+		case 0x2D: return(UART5_IRQn);
+		case 0x2E: return(CAN1_RX0_IRQn);
+		case 0x2F: return(CAN2_RX0_IRQn);
+		case 0x30: return(OTG_FS_IRQn);
+		case 0x31: return(ETH_IRQn);
+		#else
+		case 0x2E: return(USB_LP_CAN1_RX0_IRQn);
+		case 0x30: return(USB_LP_CAN1_RX0_IRQn);
+		#endif
+		default: return(-1);
+	}
+}
+
+/**
+ * @brief SSR_MemberHandler
+ * - Adapts a member function to SSR_ContextHandler (the context is the object).
+ */
+template <typename C, void (C::*Member)()>
+void SSR_MemberHandler(void* Context){
+	(static_cast<C*>(Context)->*Member)();
+}
+
+/**
+ * @brief SSR_AllocateMember
+ * - Binds an object's member function to a vector, i. e.:
+ * @code
+ *  SSR_AllocateMember<CUart, &CUart::OnInterrupt>(this, SSR_VECTOR(USART1_IRQn));
+ * @endcode
+ * @arg Object: the object receiving the interrupts
+ * @arg VectorIndex: the position in the vector table
+ */
+template <typename C, void (C::*Member)()>
+inline void SSR_AllocateMember(C* Object, uint32_t VectorIndex){
+	SSR_AllocateContext(SSR_MemberHandler<C, Member>, Object, VectorIndex);
+}
+}
 #endif
 //------------------------------------------------------------------------------
 
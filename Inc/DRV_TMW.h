@@ -0,0 +1,128 @@
+//==============================================================================
+/** @file DRV_TMW.h
+ *  @brief Timing Wheel Kernel Driver
+ *  Hierarchical timing wheel (3 levels of 64 slots plus an overflow list)
+ *  with O(1) arm, cancel and per-tick expiry. Timers come from a static pool
+ *  of __SYS_MAX_TIMERS entries, no heap is used.
+ *  @version 1.0.0
+ *  @author J. Nilo Rodrigues - nilo@pobox.com
+ *
+ *------------------------------------------------------------------------------
+ *
+ * <h2><center>&copy; Copyright (c) 2020 Joao Nilo Rodrigues </center></h2>
+ * <h2><center> All rights reserved. </center></h2>
+ *
+ * This software component is licensed by "Joao Nilo Rodrigues" under BSD 3-Clause
+ * license, the "License".
+ * You may not use this file except in compliance with the License.
+ *               You may obtain a copy of the License at:
+ *                 opensource.org/licenses/BSD-3-Clause
+ *
+ *///---------------------------------------------------------------------------
+#ifndef DRV_TMW_H
+    #define DRV_TMW_H
+
+	#include <stddef.h>
+	#include "GenericTypeDefs.h"
+
+//------------------------------------------------------------------------------
+/**
+ * @if cond_macros
+ */
+#define TMW_SLOT_BITS			6
+#define TMW_SLOTS				(1 << TMW_SLOT_BITS)
+#define TMW_SLOT_MASK			(TMW_SLOTS - 1)
+#define TMW_LEVELS				3
+#define TMW_OVERFLOW			(TMW_LEVELS * TMW_SLOTS)
+#define TMW_LISTS				(TMW_OVERFLOW + 1)
+#define TMW_NONE				((uint16_t) 0xFFFF)
+/**
+ * @endif
+ */
+
+#define TMW_INVALID				((uint32_t) 0x00000000)
+#define TMW_MAX_TICKS			((uint32_t) 0x7FFFFFFF)		// expiries compare modulo 2^32
+
+/**
+ * @brief Timer expiry callback.
+ * @arg Handle: the (now released) handle of the expired timer
+ * @arg Context: the context pointer given to TMW_Arm()
+ * @arg Data: the data word given to TMW_Arm()
+ */
+typedef void (*TMW_Callback)(uint32_t Handle, void* Context, uint32_t Data);
+
+/**
+ *  @defgroup DRV_TMW
+ *  @{
+ */
+
+//------------------------------------------------------------------------------
+/**
+ * @brief TMW_Initialize
+ * - Empties the wheel and returns all the timers to the pool.
+ */
+void TMW_Initialize();
+
+/**
+ * @brief TMW_Arm
+ * - Arms a one-shot timer.
+ * @arg Ticks: time to expiry in wheel ticks (values below 1 are taken as 1),
+ * up to TMW_MAX_TICKS
+ * @arg Callback: function called on expiry (from TMW_Tick context)
+ * @arg Context: callback context pointer
+ * @arg Data: callback data word
+ * @return the timer handle, or TMW_INVALID if the pool is exhausted or Ticks
+ * is above TMW_MAX_TICKS.
+ */
+uint32_t TMW_Arm(uint32_t Ticks, TMW_Callback Callback, void* Context, uint32_t Data);
+
+/**
+ * @brief TMW_Cancel
+ * - Cancels an armed timer.
+ * @arg Handle: the timer handle
+ * @return false if the handle is stale (the timer already expired or was cancelled).
+ */
+bool TMW_Cancel(uint32_t Handle);
+
+/**
+ * @brief TMW_Reschedule
+ * - Moves an armed timer to a new expiry time, keeping its handle.
+ * @arg Handle: the timer handle
+ * @arg Ticks: new time to expiry, counted from now (up to TMW_MAX_TICKS)
+ * @return false if the handle is stale or Ticks is above TMW_MAX_TICKS (the
+ * timer then keeps its expiry).
+ */
+bool TMW_Reschedule(uint32_t Handle, uint32_t Ticks);
+
+/**
+ * @brief TMW_IsArmed
+ * @arg Handle: the timer handle
+ * @return true if the timer is still pending.
+ */
+bool TMW_IsArmed(uint32_t Handle);
+
+/**
+ * @brief TMW_Tick
+ * - Advances the wheel by one tick and runs the callbacks of the expired timers.
+ * @note Called by the kernel on every SysTick.
+ */
+void TMW_Tick();
+
+/**
+ * @brief TMW_GetTime
+ * @return the number of ticks since TMW_Initialize().
+ */
+uint32_t TMW_GetTime();
+
+/**
+ * @brief TMW_GetArmed
+ * @return the number of armed timers.
+ */
+uint32_t TMW_GetArmed();
+
+/**
+ * @} // close group DRV_TMW
+ */
+
+#endif
+//==============================================================================
@@ -0,0 +1,114 @@
+//==============================================================================
+/** @file DRV_TRC.h
+ *  @brief Trace Ring Kernel Driver
+ *  Fixed-size binary ring of the last thrown exceptions and messages, kept in
+ *  the ".noinit" RAM section so the history survives a watchdog (or warm)
+ *  reset. Each record is a handful of stores, with no formatting: the ring is
+ *  decoded off-target by Tools/trc_decode.py.
+ *  @version 1.0.0
+ *  @author J. Nilo Rodrigues - nilo@pobox.com
+ *
+ *------------------------------------------------------------------------------
+ *
+ * <h2><center>&copy; Copyright (c) 2020 Joao Nilo Rodrigues </center></h2>
+ * <h2><center> All rights reserved. </center></h2>
+ *
+ * This software component is licensed by "Joao Nilo Rodrigues" under BSD 3-Clause
+ * license, the "License".
+ * You may not use this file except in compliance with the License.
+ *               You may obtain a copy of the License at:
+ *                 opensource.org/licenses/BSD-3-Clause
+ *
+ *///---------------------------------------------------------------------------
+#ifndef DRV_TRC_H
+    #define DRV_TRC_H
+
+	#include <stddef.h>
+	#include "GenericTypeDefs.h"
+
+//------------------------------------------------------------------------------
+/**
+ * @def TRC_DEPTH
+ * - number of records kept in the ring (must be a power of two)
+ * @note The recording hooks in DRV_SSR and DRV_MSG are only built with SSR_TRACE.
+ */
+#ifndef TRC_DEPTH
+	#define TRC_DEPTH				16
+#endif
+
+#define TRC_MAGIC					((uint32_t) 0x54524331)		// "TRC1"
+
+#define TRC_KIND_EXCEPTION			((uint8_t) 0x01)			//!< SSR_ThrowException (Code = NX_*)
+#define TRC_KIND_MESSAGE			((uint8_t) 0x02)			//!< SSR_ThrowMessage / MSG_Post (Code = message)
+#define TRC_KIND_USER				((uint8_t) 0x10)			//!< first application defined kind
+
+//------------------------------------------------------------------------------
+/**
+ * @brief Trace record (6 words, little endian).
+ */
+struct TRC_Entry{
+	uint32_t Cycles;					//!< DWT->CYCCNT at the throw
+	uint32_t Milliseconds;				//!< system time at the throw (see TRC_Record())
+	uint32_t Info;						//!< kind (bits 31..24) and sequence number (bits 23..0)
+	uint32_t Code;						//!< exception code or message id
+	uint32_t Data1;						//!< first data word
+	uint32_t Data2;						//!< second data word
+};
+
+/**
+ * @brief Trace block, as found in RAM (and in a memory dump).
+ */
+struct TRC_Block{
+	uint32_t Magic;						//!< TRC_MAGIC when the block is valid
+	uint32_t Head;						//!< total number of records written (next = Head % Depth)
+	uint32_t Clock;						//!< SystemCoreClock, to convert the cycle stamps
+	uint32_t Depth;						//!< TRC_DEPTH
+	TRC_Entry Records[TRC_DEPTH];		//!< the ring
+};
+
+/**
+ *  @defgroup DRV_TRC
+ *  @{
+ */
+
+//------------------------------------------------------------------------------
+/**
+ * @brief TRC_Initialize
+ * - Prepares the trace ring and enables the DWT cycle counter.
+ * @arg Preserve: keep the records of the previous run, i. e. CPU_CheckWatchdog()
+ * or CPU_CheckWarmStart(); a cold start always clears the ring.
+ * @return the number of preserved records.
+ */
+uint32_t TRC_Initialize(bool Preserve);
+
+/**
+ * @brief TRC_Record
+ * - Appends a record to the ring (the oldest record is overwritten).
+ * @arg Kind: TRC_KIND_*
+ * @arg Code: exception code or message id
+ * @arg Data1, Data2: data words
+ * @note Callable from any context; interrupts are masked for a few stores.
+ * @note The time comes from the kernel's SVC_GET_SYSTEM_TIME service, i. e.
+ * the SSR_PublishTime() block unless the kernel serves the time itself (see
+ * DRV_SSR); with neither it reads 0, and only Cycles orders the records.
+ */
+void TRC_Record(uint8_t Kind, uint32_t Code, uint32_t Data1, uint32_t Data2);
+
+/**
+ * @brief TRC_GetBlock
+ * - Returns the trace block, i. e. to send it over a serial link.
+ */
+const TRC_Block* TRC_GetBlock();
+
+/**
+ * @brief TRC_Count
+ * @return the number of valid records in the ring.
+ */
+uint32_t TRC_Count();
+
+/**
+ * @} // close group DRV_TRC
+ */
+
+#endif
+//==============================================================================
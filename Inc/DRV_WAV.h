@@ -0,0 +1,159 @@
+//==============================================================================
+/** @file DRV_WAV.h
+ *  @brief Waveform Output Engine
+ *  Streams a precomputed buffer of BSRR words to a GPIO port by DMA, one
+ *  word per update event of a timer: parallel buses, WS2812-style LEDs or
+ *  synchronous protocols come out jitter-free without CPU time. The
+ *  WAV_Compile*() helpers build the BSRR buffers.
+ *  @version 1.0.0
+ *  @author J. Nilo Rodrigues - nilo@pobox.com
+ *
+ *------------------------------------------------------------------------------
+ *
+ * <h2><center>&copy; Copyright (c) 2020 Joao Nilo Rodrigues </center></h2>
+ * <h2><center> All rights reserved. </center></h2>
+ *
+ * This software component is licensed by "Joao Nilo Rodrigues" under BSD 3-Clause
+ * license, the "License".
+ * You may not use this file except in compliance with the License.
+ *               You may obtain a copy of the License at:
+ *                 opensource.org/licenses/BSD-3-Clause
+ *
+ *///---------------------------------------------------------------------------
+#ifndef DRV_WAV_H
+    #define DRV_WAV_H
+
+	#include <stddef.h>
+	#include "stm32f1xx.h"
+	#include "GenericTypeDefs.h"
+	#include "Priorities.h"
+
+//------------------------------------------------------------------------------
+/**
+ * @def WAV_TIMER
+ * - timer pacing the transfer and the DMA1 channel of its UP request:
+ * TIM2 (channel 2), TIM3 (channel 3), TIM4 (channel 7), or TIM1 (channel 5)
+ * with WAV_TIMER_APB2 defined.
+ * @def WAV_PRIORITY
+ * - interrupt priority of the DMA channel (end of transfer events)
+ */
+#ifndef WAV_TIMER
+	#define WAV_TIMER				TIM3
+	#define WAV_TIMER_CLOCK			RCC_APB1ENR_TIM3EN
+	#define WAV_DMA					DMA1_Channel3
+	#define WAV_DMA_IRQn			DMA1_Channel3_IRQn
+#endif
+
+#ifndef WAV_PRIORITY
+	#define WAV_PRIORITY			SYS_PRIORITY_LEVEL_3
+#endif
+
+#define WAV_EVENT_HALF				((uint32_t) 0x01)		//!< first half of the buffer sent (circular mode)
+#define WAV_EVENT_DONE				((uint32_t) 0x02)		//!< buffer sent (wraps around in circular mode)
+#define WAV_EVENT_ERROR				((uint32_t) 0x04)		//!< DMA transfer error (output stopped)
+
+/**
+ * @brief Transfer event callback, called from the DMA interrupt.
+ * @arg Event: WAV_EVENT_*
+ * @arg Context: the context pointer given to WAV_Start()
+ */
+typedef void (*WAV_Callback)(uint32_t Event, void* Context);
+
+/**
+ * @brief Bit encoding for WAV_CompileBits(): each bit takes Slots words; the
+ * pins are high for the first One (or Zero) slots and low for the rest.
+ */
+struct WAV_BitCode{
+	uint8_t Slots;					//!< words per bit
+	uint8_t One;					//!< high slots of a "1"
+	uint8_t Zero;					//!< high slots of a "0"
+};
+
+#define WAV_CODE_NRZ				{1, 1, 0}		//!< one word per bit, level = bit
+#define WAV_CODE_WS2812				{3, 2, 1}		//!< 800 kbit/s at 2.4 MHz: 1 = HHL, 0 = HLL
+
+/**
+ *  @defgroup DRV_WAV
+ *  @{
+ */
+
+//------------------------------------------------------------------------------
+/**
+ * @brief WAV_Initialize
+ * - Turns the timer and DMA clocks on and installs the DMA interrupt handler.
+ */
+void WAV_Initialize();
+
+/**
+ * @brief WAV_Start
+ * - Starts streaming a buffer of BSRR words to a port.
+ * @arg Port is the port "base-address" (i. e. GPIOA, GPIOB, etc)
+ * @arg Buffer: the BSRR words (must stay valid during the transfer)
+ * @arg Count: the number of words
+ * @arg Frequency: words per second (the timer update rate)
+ * @arg Circular: repeat the buffer until WAV_Stop(); WAV_EVENT_HALF and
+ * WAV_EVENT_DONE allow refilling each half while the other one is sent.
+ * @arg Callback: optional event callback (may be NULL)
+ * @arg Context: the callback context pointer
+ * @return false if an output is already running or the arguments are invalid.
+ */
+bool WAV_Start(GPIO_TypeDef* Port, const uint32_t* Buffer, uint16_t Count, uint32_t Frequency,
+		bool Circular, WAV_Callback Callback, void* Context);
+
+/**
+ * @brief WAV_Stop
+ * - Stops the output (the pins keep the last written levels).
+ */
+void WAV_Stop();
+
+/**
+ * @brief WAV_IsBusy
+ * @return true while an output is running.
+ */
+bool WAV_IsBusy();
+
+/**
+ * @brief WAV_CompileBits
+ * - Encodes a bit sequence (MSB first) on the pins of PinMask.
+ * @arg Buffer: the BSRR words output
+ * @arg Max: the buffer size, in words
+ * @arg PinMask: the pins driven by the sequence (usually one)
+ * @arg Data: the bits, MSB of Data[0] first
+ * @arg Bits: the number of bits
+ * @arg Code: the bit encoding (i. e. WAV_CODE_NRZ, WAV_CODE_WS2812)
+ * @return the number of words written, 0 if the buffer is too small.
+ */
+uint32_t WAV_CompileBits(uint32_t* Buffer, uint32_t Max, uint16_t PinMask,
+		const uint8_t* Data, uint32_t Bits, const WAV_BitCode& Code);
+
+/**
+ * @brief WAV_CompileBus
+ * - Encodes values for a parallel bus: (Value << Shift) & BusMask drives
+ * the bus pins. With a StrobeMask, each value takes two words: the data with
+ * the strobe pins low, then the strobe pins high (write on rising edge).
+ * @arg Buffer: the BSRR words output
+ * @arg Max: the buffer size, in words
+ * @arg BusMask: the data pins
+ * @arg Shift: the position of the value's bit 0 on the port
+ * @arg StrobeMask: the strobe (write clock) pins, 0 for none
+ * @arg Values: the bus values
+ * @arg N: the number of values
+ * @return the number of words written, 0 if the buffer is too small.
+ */
+uint32_t WAV_CompileBus(uint32_t* Buffer, uint32_t Max, uint16_t BusMask, uint32_t Shift,
+		uint16_t StrobeMask, const uint16_t* Values, uint32_t N);
+
+/**
+ * @brief WAV_Handler
+ * - DMA channel interrupt handler (installed by WAV_Initialize()).
+ * @note With SSR_FLASH_VECTORS add X(NV_DMA1_CH3, WAV_Handler) (or the
+ * vector of WAV_DMA) to SSR_FLASH_HANDLERS.
+ */
+extern "C" void WAV_Handler(void);
+
+/**
+ * @} // close group DRV_WAV
+ */
+
+#endif
+//==============================================================================
@@ -35,13 +35,26 @@
  * @def __SYS_MAX_OBJECTS
  * - size of the notification table (total capacity of instantiated NComponents)
  */
-#define __SYS_MAX_OBJECTS       32
+#ifndef __SYS_MAX_OBJECTS
+	#define __SYS_MAX_OBJECTS       32
+#endif
 
 /**
  * @def __SYS_MAX_SIGNALS
- * - size of the "high priority" notification queue (total capacity of pending events)
+ * - size of the "high priority" notification queue (total capacity of pending events),
+ * rounded up to a power of two by the message lanes (see @ref DRV_MSG)
+ */
+#ifndef __SYS_MAX_SIGNALS
+	#define __SYS_MAX_SIGNALS        3
+#endif
+
+/**
+ * @def __SYS_MAX_TIMERS
+ * - size of the timing wheel pool (total capacity of armed timeouts)
  */
-#define __SYS_MAX_SIGNALS        3
+#ifndef __SYS_MAX_TIMERS
+	#define __SYS_MAX_TIMERS        64
+#endif
 
 //------------------------------------------------------------------------------
 typedef uint32_t* 				HANDLE;
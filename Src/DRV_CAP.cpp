@@ -0,0 +1,184 @@
+//==============================================================================
+#include "DRV_CAP.h"
+#include "DRV_CPU.h"
+#include "DRV_DMA.h"
+#include "DRV_SSR.h"
+
+//------------------------------------------------------------------------------
+// IDR read as a word, stored as a half-word
+#define CAP_CCR		(DMA_CCR_ALL | DMA_CCR_CIRC | DMA_CCR_MINC | DMA_CCR_PSIZE_1 | DMA_CCR_MSIZE_0 | DMA_CCR_PL_1)
+
+static uint16_t* CapBuffer = NULL;
+static uint32_t CapCount = 0;
+static uint32_t CapHalves = 0;				// halves filled since CAP_Start()
+static uint32_t CapEnd = 0;					// next write position when stopped (oldest sample)
+static uint32_t CapTrigger = CAP_CONTINUOUS;	// buffer index of the trigger sample
+static uint32_t CapRemaining = 0;			// samples still to take after the trigger
+static uint32_t CapPost = 0;
+static CAP_Trigger CapPattern;
+static CAP_Callback CapCallback = NULL;
+static void* CapContext = NULL;
+
+//------------------------------------------------------------------------------
+// clock of the timer, from the bus it sits on
+#ifdef CAP_TIMER_APB2
+	#define CAP_TIMER_FREQUENCY()		CPU_GetTimerFrequencyAPB2()
+#else
+	#define CAP_TIMER_FREQUENCY()		CPU_GetTimerFrequencyAPB1()
+#endif
+
+//------------------------------------------------------------------------------
+void CAP_Initialize(){
+#ifdef CAP_TIMER_APB2
+	RCC->APB2ENR |= CAP_TIMER_CLOCK;
+#else
+	RCC->APB1ENR |= CAP_TIMER_CLOCK;
+#endif
+	RCC->AHBENR |= RCC_AHBENR_DMA1EN;
+
+	CAP_TIMER->CR1 = 0;
+	CAP_TIMER->DIER = 0;
+	DMA_Stop(CAP_DMA);
+
+	SSR_Allocate((uint32_t)CAP_Handler, SSR_VECTOR(CAP_DMA_IRQn));
+	CPU_SetPriorityIRQn(CAP_DMA_IRQn, CAP_PRIORITY);
+	NVIC_EnableIRQ(CAP_DMA_IRQn);
+}
+
+//------------------------------------------------------------------------------
+bool CAP_Start(GPIO_TypeDef* Port, uint16_t* Buffer, uint16_t Count, uint32_t Frequency,
+		const CAP_Trigger& Trigger, uint32_t PostTrigger, CAP_Callback Callback, void* Context){
+	if((Port == NULL) || (Buffer == NULL) || (Count < 2) || (Count & 1) || (Frequency == 0) || CAP_IsBusy()){
+		return(false);
+	}
+
+	uint32_t ticks = CAP_TIMER_FREQUENCY() / Frequency;
+	if(ticks < 2){ ticks = 2;}
+	uint32_t prescaler = (ticks - 1) >> 16;
+
+	CapBuffer = Buffer;
+	CapCount = Count;
+	CapHalves = 0;
+	CapEnd = 0;
+	CapPattern = Trigger;
+	CapPost = (PostTrigger == CAP_CONTINUOUS)? PostTrigger : (PostTrigger > (Count / 2u))? (Count / 2u) : PostTrigger;
+	CapTrigger = (Trigger.Mask == 0)? 0 : CAP_CONTINUOUS;
+	CapRemaining = CapPost;
+	CapCallback = Callback;
+	CapContext = Context;
+
+	CAP_TIMER->CR1 = 0;
+	CAP_TIMER->DIER = 0;
+	CAP_TIMER->PSC = prescaler;
+	CAP_TIMER->ARR = (ticks / (prescaler + 1)) - 1;
+	CAP_TIMER->EGR = TIM_EGR_UG;
+	CAP_TIMER->SR = 0;
+
+	if(!DMA_Start(CAP_DMA, &Port->IDR, Buffer, Count, CAP_CCR)){ return(false);}
+
+	CAP_TIMER->DIER = TIM_DIER_UDE;
+	CAP_TIMER->CR1 = TIM_CR1_ARPE | TIM_CR1_CEN;
+	return(true);
+}
+
+//------------------------------------------------------------------------------
+void CAP_Stop(){
+	CAP_TIMER->CR1 = 0;
+	CAP_TIMER->DIER = 0;
+	uint32_t left = DMA_Stop(CAP_DMA);
+	CapEnd = (CapCount - left) % (CapCount? CapCount : 1);
+}
+
+//------------------------------------------------------------------------------
+bool CAP_IsBusy(){
+	return(CAP_TIMER->CR1 & TIM_CR1_CEN);
+}
+
+//------------------------------------------------------------------------------
+// a half buffer is complete: trigger search and post-trigger count
+static uint32_t CAP_Process(uint32_t First){
+	uint32_t result = 0;
+	uint32_t half = CapCount / 2;
+	CapHalves++;
+
+	if(CapTrigger == CAP_CONTINUOUS){
+		for(uint32_t i=First; i<(First + half); i++){
+			if((CapBuffer[i] & CapPattern.Mask) == CapPattern.Value){
+				CapTrigger = i;
+				result |= CAP_EVENT_TRIGGER;
+				break;
+			}
+		}
+		if(CapTrigger == CAP_CONTINUOUS){ return(result);}
+		uint32_t after = (First + half) - CapTrigger - 1;
+		if(CapRemaining != CAP_CONTINUOUS){ CapRemaining = (CapRemaining > after)? (CapRemaining - after) : 0;}
+	} else if(CapRemaining != CAP_CONTINUOUS){
+		CapRemaining = (CapRemaining > half)? (CapRemaining - half) : 0;
+	}
+
+	if(CapRemaining == 0){
+		CAP_Stop();
+		result |= CAP_EVENT_DONE;
+	}
+	return(result);
+}
+
+//------------------------------------------------------------------------------
+extern "C" void CAP_Handler(void){
+	uint32_t event = 0;
+	bool half = DMA_CheckInterrupts(CAP_DMA, DMA_ISR_HTIF1);
+	bool full = DMA_CheckInterrupts(CAP_DMA, DMA_ISR_TCIF1);
+	bool error = DMA_CheckInterrupts(CAP_DMA, DMA_ISR_TEIF1);
+	DMA_ClearInterrupts(CAP_DMA, DMA_IFCR_ALL);
+
+	if(error){ CAP_Stop(); event |= CAP_EVENT_DONE;}
+	else {
+		// both flags: the interrupt was late, the halves are handled in write order
+		bool fullFirst = half && full && ((CapCount - CAP_DMA->CNDTR) >= (CapCount / 2));
+		if(full && fullFirst){ event |= CAP_EVENT_FULL | CAP_Process(CapCount / 2);}
+		if(half && !(event & CAP_EVENT_DONE)){ event |= CAP_EVENT_HALF | CAP_Process(0);}
+		if(full && !fullFirst && !(event & CAP_EVENT_DONE)){ event |= CAP_EVENT_FULL | CAP_Process(CapCount / 2);}
+	}
+	if((event != 0) && (CapCallback != NULL)){ CapCallback(event, CapContext);}
+}
+
+//------------------------------------------------------------------------------
+uint32_t CAP_GetSamples(){
+	return((CapHalves >= 2)? CapCount : CapEnd);
+}
+
+//------------------------------------------------------------------------------
+uint16_t CAP_GetSample(uint32_t Index){
+	uint32_t first = (CapHalves >= 2)? CapEnd : 0;
+	return(CapBuffer[(first + Index) % CapCount]);
+}
+
+//------------------------------------------------------------------------------
+uint32_t CAP_GetTrigger(){
+	if(CapTrigger == CAP_CONTINUOUS){ return(CAP_CONTINUOUS);}
+	uint32_t first = (CapHalves >= 2)? CapEnd : 0;
+	return((CapTrigger + CapCount - first) % CapCount);
+}
+
+//------------------------------------------------------------------------------
+uint32_t CAP_Compress(CAP_Run* Runs, uint32_t Max){
+	uint32_t result = 0;
+	uint32_t n = CAP_GetSamples();
+	if((Max == 0) || (n == 0)){ return(0);}
+
+	Runs[0].Value = CAP_GetSample(0);
+	Runs[0].Length = 1;
+	for(uint32_t i=1; i<n; i++){
+		uint16_t v = CAP_GetSample(i);
+		if((v == Runs[result].Value) && (Runs[result].Length != 0xFFFF)){
+			Runs[result].Length++;
+			continue;
+		}
+		if(++result == Max){ return(Max);}
+		Runs[result].Value = v;
+		Runs[result].Length = 1;
+	}
+	return(result + 1);
+}
+
+//==============================================================================
@@ -1,6 +1,7 @@
 //==============================================================================
 #include "DRV_CPU.h"
 #include <math.h>
+#include <stddef.h>
 #include "Priorities.h"
 
 //------------------------------------------------------------------------------
@@ -53,11 +54,38 @@ void CPU_StartHSI(){
     SystemCoreClockUpdate();
 }
 
+//------------------------------------------------------------------------------
+static CPU_NoInitBlock CpuNoInit CPU_NOINIT;
+
+//------------------------------------------------------------------------------
+// check if the PLL is already locked and feeding SYSCLK with the given setup
+static bool CPU_CheckPLL(PllSources PllSource, uint32_t PllDiv, uint32_t PllMul){
+    uint32_t cfgr = RCC->CFGR;
+
+    if(!(RCC->CR & RCC_CR_PLLRDY)){ return(false);}
+    if((cfgr & RCC_CFGR_SWS) != RCC_CFGR_SWS_PLL){ return(false);}
+    if((cfgr & RCC_CFGR_PLLMULL) != PllMul){ return(false);}
+    if(((cfgr & RCC_CFGR_PLLSRC) != 0) != (PllSource == Pll_Hse)){ return(false);}
+
+    #ifdef STM32F10X_CL
+        if((RCC->CFGR2 & RCC_CFGR2_PREDIV1) != PllDiv){ return(false);}
+    #else
+        if(((cfgr & RCC_CFGR_PLLXTPRE) != 0) != (PllDiv == RCC_PREDIV1_DIV2)){ return(false);}
+    #endif
+
+    return(true);
+}
+
 //------------------------------------------------------------------------------
 void CPU_StartPLL(PllSources PllSource, PllFrequencies CpuSpeed){
     uint32_t PllDiv = PllFactors[CpuSpeed][0];
     uint32_t PllMul = PllFactors[CpuSpeed][1];
 
+    if(CPU_CheckPLL(PllSource, PllDiv, PllMul)){
+        SystemCoreClockUpdate();
+        return;
+    }
+
     CPU_StartHSI();
 	RCC->CFGR &= ~RCC_CFGR_PLLSRC;
     
@@ -130,7 +158,7 @@ uint32_t CPU_GetFrequencyAPB1(){
     uint32_t result = 1;
     uint32_t Div = (RCC->CFGR & RCC_CFGR_PPRE1)>>8;
     if(Div < 4){ Div = 1;}
-    else { Div = 2 + (Div - 4);}
+    else { Div = (2 << (Div - 4));}
     result = SystemCoreClock / Div;
     return(result);
 }
@@ -155,11 +183,10 @@ void CPU_SetFrequencyAPB2(BusFrequencies BusSpeed){
 //------------------------------------------------------------------------------
 uint32_t CPU_GetFrequencyAPB2(){
     uint32_t result = 1;
-    uint32_t Mul = 1;
     uint32_t Div = (RCC->CFGR & RCC_CFGR_PPRE2)>>11;
     if(Div < 4){ Div = 1;}
-    else { Div = (2 << (Div - 4)); Mul = 2;}
-    result = (SystemCoreClock / Div) * Mul;
+    else { Div = (2 << (Div - 4));}
+    result = SystemCoreClock / Div;
     return(result);
 }
 
@@ -169,7 +196,7 @@ uint32_t CPU_GetTimerFrequencyAPB2(){
     uint32_t Mul = 1;
     uint32_t Div = (RCC->CFGR & RCC_CFGR_PPRE2)>>11;
     if(Div < 4){ Div = 1;}
-    else { Div = 2 + (Div - 4); Mul = 2;}
+    else { Div = (2 << (Div - 4)); Mul = 2;}
     result = (SystemCoreClock / Div) * Mul;
     return(result);
 }
@@ -649,6 +676,106 @@ void CPU_Reset(){
 	while(1);
 }
 
+//------------------------------------------------------------------------------
+static uint32_t CPU_NoInitCrc(){
+	return(CPU_Crc32((uint8_t*)&CpuNoInit, (uint16_t)offsetof(CPU_NoInitBlock, Crc)));
+}
+
+//------------------------------------------------------------------------------
+// peripherals back to their reset state; the RCC clock tree (oscillators, PLL,
+// prescalers), the backup domain and the PWR settings are left untouched
+static void CPU_ResetPeripherals(){
+	DMA_Channel_TypeDef* const channels[] = {
+		DMA1_Channel1, DMA1_Channel2, DMA1_Channel3, DMA1_Channel4, DMA1_Channel5, DMA1_Channel6, DMA1_Channel7,
+		#ifdef DMA2
+		DMA2_Channel1, DMA2_Channel2, DMA2_Channel3, DMA2_Channel4, DMA2_Channel5,
+		#endif
+	};
+
+	// no reset line for the DMA controllers: stop every channel
+	RCC->AHBENR |= RCC_AHBENR_DMA1EN;
+	#ifdef DMA2
+		RCC->AHBENR |= RCC_AHBENR_DMA2EN;
+		DMA2->IFCR = 0xFFFFFFFF;
+	#endif
+	for(uint32_t i=0; i<(sizeof(channels) / sizeof(channels[0])); i++){ channels[i]->CCR = 0;}
+	DMA1->IFCR = 0xFFFFFFFF;
+
+	RCC->APB1RSTR = ~(RCC_APB1RSTR_BKPRST | RCC_APB1RSTR_PWRRST);
+	RCC->APB1RSTR = 0;
+	RCC->APB2RSTR = 0xFFFFFFFF;
+	RCC->APB2RSTR = 0;
+	#ifdef RCC_AHBRSTR_OTGFSRST
+		RCC->AHBRSTR = 0xFFFFFFFF;
+		RCC->AHBRSTR = 0;
+	#endif
+
+	RCC->AHBENR = RCC_AHBENR_SRAMEN | RCC_AHBENR_FLITFEN;
+	RCC->APB2ENR = 0;
+	RCC->APB1ENR = 0;
+	RCC->CIR = 0x00FF0000;				// clock interrupts off, flags cleared
+}
+
+//------------------------------------------------------------------------------
+// warm: peripherals reset, fresh stack, branch to Reset_Handler (clocks kept);
+// cold fallback (SYSRESETREQ) from handler mode or unprivileged code
+void CPU_WarmReset(uint32_t Reason){
+	__disable_irq();
+	if((CpuNoInit.Magic == ~CPU_WARMSTART_MAGIC) && (CpuNoInit.Crc == CPU_NoInitCrc())){ CpuNoInit.Restarts++;}
+	else { CpuNoInit.Restarts = 0;}
+	CpuNoInit.Magic = CPU_WARMSTART_MAGIC;
+	CpuNoInit.Reason = Reason;
+	CpuNoInit.Crc = CPU_NoInitCrc();
+	__DSB();
+
+	if((__get_IPSR() != 0) || (__get_CONTROL() & CONTROL_nPRIV_Msk)){
+		SCB->AIRCR = CPU_COLDRESET_KEY | (SCB->AIRCR & SCB_AIRCR_PRIGROUP_Msk);
+		__DSB();
+		while(1);
+	}
+
+	SysTick->CTRL = 0;
+	for(uint32_t i=0; i<(sizeof(NVIC->ICER) / sizeof(NVIC->ICER[0])); i++){
+		NVIC->ICER[i] = 0xFFFFFFFF;
+		NVIC->ICPR[i] = 0xFFFFFFFF;
+	}
+	SCB->ICSR = SCB_ICSR_PENDSTCLR_Msk | SCB_ICSR_PENDSVCLR_Msk;
+	CPU_ResetPeripherals();
+
+	// what the core loads at reset: SP and PC from the boot table
+	const volatile uint32_t* boot = (const volatile uint32_t*)FLASH_BASE;
+	SCB->VTOR = FLASH_BASE;
+	__set_CONTROL(0);					// MSP, privileged
+	__ISB();
+	__asm volatile(
+		"msr msp, %0	\n"
+		"cpsie i		\n"
+		"bx %1			\n"
+		: : "r" (boot[0]), "r" (boot[1]) : "memory");
+	while(1);
+}
+
+//------------------------------------------------------------------------------
+extern "C" bool CPU_IsWarmStart(void){
+	return((CpuNoInit.Magic == CPU_WARMSTART_MAGIC) && (CpuNoInit.Crc == CPU_NoInitCrc()));
+}
+
+//------------------------------------------------------------------------------
+bool CPU_CheckWarmStart(){
+	bool result = false;
+	if(CPU_IsWarmStart()){
+		result = true;
+		CpuNoInit.Magic = ~CPU_WARMSTART_MAGIC;
+		CpuNoInit.Crc = CPU_NoInitCrc();
+	}
+	return(result);
+}
+
+//------------------------------------------------------------------------------
+CPU_NoInitBlock* CPU_GetNoInit(){
+	return(&CpuNoInit);
+}
+
 //------------------------------------------------------------------------------
 uint32_t CPU_Crc32(uint8_t* pt, uint16_t n){
 	CPU_PeripheralClockEnable(CRC);
@@ -0,0 +1,106 @@
+//==============================================================================
+#include "DRV_DEB.h"
+#include "DRV_MSG.h"
+#include "DRV_TMW.h"
+#include "DRV_IO.h"
+
+//------------------------------------------------------------------------------
+struct DEB_Port{
+	GPIO_TypeDef* Port;			// NULL when the entry is free
+	uint32_t Message;
+	uint16_t Mask;
+	uint16_t State;				// debounced levels
+	uint16_t Count0;			// vertical counter, bit 0 of each pin
+	uint16_t Count1;			// vertical counter, bit 1 of each pin
+};
+
+static DEB_Port DebPorts[DEB_PORTS];
+static volatile uint32_t DebPeriod = 0;
+static volatile uint32_t DebTimer = TMW_INVALID;
+
+//------------------------------------------------------------------------------
+static DEB_Port* DEB_Find(GPIO_TypeDef* Port){
+	for(uint32_t i=0; i<DEB_PORTS; i++){
+		if(DebPorts[i].Port == Port){ return(&DebPorts[i]);}
+	}
+	return(NULL);
+}
+
+//------------------------------------------------------------------------------
+bool DEB_Add(GPIO_TypeDef* Port, uint16_t Mask, uint32_t Message){
+	uint32_t primask = __get_PRIMASK();
+	__disable_irq();
+	DEB_Port* p = DEB_Find(Port);
+	if(p == NULL){
+		p = DEB_Find(NULL);
+		if(p != NULL){ p->Mask = 0;}
+	}
+	if(p != NULL){
+		uint16_t added = Mask & ~p->Mask;
+		p->State = (p->State & ~added) | (Port->IDR & added);
+		p->Count0 &= ~added;
+		p->Count1 &= ~added;
+		p->Mask |= Mask;
+		p->Message = Message;
+		p->Port = Port;
+	}
+	__set_PRIMASK(primask);
+	return(p != NULL);
+}
+
+//------------------------------------------------------------------------------
+void DEB_Remove(GPIO_TypeDef* Port){
+	DEB_Port* p = (Port != NULL)? DEB_Find(Port) : NULL;
+	if(p != NULL){ p->Port = NULL;}
+}
+
+//------------------------------------------------------------------------------
+uint16_t DEB_GetState(GPIO_TypeDef* Port){
+	DEB_Port* p = (Port != NULL)? DEB_Find(Port) : NULL;
+	return((p != NULL)? (p->State & p->Mask) : 0);
+}
+
+//------------------------------------------------------------------------------
+// a pin that differs from its stable state for DEB_SAMPLES ticks in a row
+// wraps its counter to zero and toggles; any equal sample resets the counter
+void DEB_Tick(){
+	for(uint32_t i=0; i<DEB_PORTS; i++){
+		DEB_Port* p = &DebPorts[i];
+		if(p->Port == NULL){ continue;}
+
+		uint16_t delta = (p->Port->IDR ^ p->State) & p->Mask;
+		p->Count1 = (p->Count1 ^ p->Count0) & delta;
+		p->Count0 = ~p->Count0 & delta;
+		uint16_t changed = delta & ~(p->Count0 | p->Count1);
+		if(changed == 0){ continue;}
+
+		p->State ^= changed;
+		NMESSAGE msg = {p->Message, changed, (uint32_t)(p->State & p->Mask), GetPortIndex(p->Port)};
+		MSG_Post(DEB_LANE, msg);
+	}
+}
+
+//------------------------------------------------------------------------------
+static void DEB_Timer(uint32_t, void*, uint32_t){
+	DEB_Tick();
+	uint32_t period = DebPeriod;
+	DebTimer = period? TMW_Arm(period, DEB_Timer, NULL, 0) : TMW_INVALID;
+}
+
+//------------------------------------------------------------------------------
+bool DEB_Start(uint32_t Period){
+	DEB_Stop();
+	DebPeriod = Period? Period : 1;
+	DebTimer = TMW_Arm(DebPeriod, DEB_Timer, NULL, 0);
+	if(DebTimer == TMW_INVALID){ DebPeriod = 0;}
+	return(DebTimer != TMW_INVALID);
+}
+
+//------------------------------------------------------------------------------
+void DEB_Stop(){
+	DebPeriod = 0;					// first: a timer expiring now does not re-arm
+	TMW_Cancel(DebTimer);
+	DebTimer = TMW_INVALID;
+}
+
+//==============================================================================
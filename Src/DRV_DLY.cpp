@@ -0,0 +1,180 @@
+//==============================================================================
+#include "DRV_DLY.h"
+#include "DRV_CPU.h"
+#include "DRV_SSR.h"
+
+//------------------------------------------------------------------------------
+struct DLY_Slot{
+	DLY_Continuation Continuation;
+	void* Context;
+	uint32_t Rounds;			// full 65536 us timer periods still to wait
+	uint16_t Generation;		// bumped on every release, never 0
+};
+
+static DLY_Slot DlySlots[DLY_CHANNELS];
+static volatile uint32_t DlyBusy = 0;		// channels armed or ready
+static volatile uint32_t DlyReady = 0;		// channels waiting for DLY_Dispatch()
+
+//------------------------------------------------------------------------------
+static inline volatile uint32_t* DLY_Compare(uint32_t channel){
+	return(&DLY_TIMER->CCR1 + channel);
+}
+
+// frees a channel (interrupts masked): every copy of its handle goes stale
+static inline void DLY_Release(uint32_t channel){
+	DlyReady &= ~(1 << channel);
+	DlyBusy &= ~(1 << channel);
+	if(++DlySlots[channel].Generation == 0){ DlySlots[channel].Generation = 1;}
+}
+
+// the channel of a live handle, or DLY_CHANNELS
+static inline uint32_t DLY_Resolve(uint32_t Handle){
+	uint32_t channel = Handle & DLY_INDEX_MASK;
+	if((channel >= DLY_CHANNELS) || !(DlyBusy & (1 << channel))){ return(DLY_CHANNELS);}
+	if(DlySlots[channel].Generation != (Handle >> DLY_GENERATION_SHIFT)){ return(DLY_CHANNELS);}
+	return(channel);
+}
+
+//------------------------------------------------------------------------------
+void DLY_Initialize(){
+	RCC->APB1ENR |= DLY_TIMER_CLOCK;
+
+	DLY_TIMER->CR1 = 0;
+	DLY_TIMER->DIER = 0;
+	DLY_TIMER->CCMR1 = 0;				// frozen output compare, no pin involved
+	DLY_TIMER->CCMR2 = 0;
+	DLY_TIMER->CCER = 0;
+	DLY_TIMER->PSC = (CPU_GetTimerFrequencyAPB1() / 1000000) - 1;
+	DLY_TIMER->ARR = 0xFFFF;
+	DLY_TIMER->EGR = TIM_EGR_UG;
+	DLY_TIMER->SR = 0;
+
+	for(uint32_t ch=0; ch<DLY_CHANNELS; ch++){ DLY_Release(ch);}
+
+	SSR_Allocate((uint32_t)DLY_Handler, SSR_VECTOR(DLY_TIMER_IRQn));
+	CPU_SetPriorityIRQn(DLY_TIMER_IRQn, DLY_PRIORITY);
+	NVIC_EnableIRQ(DLY_TIMER_IRQn);
+
+	DLY_TIMER->CR1 = TIM_CR1_CEN;
+}
+
+//------------------------------------------------------------------------------
+uint32_t DLY_Defer(uint32_t Microseconds, DLY_Continuation Continuation, void* Context){
+	uint32_t result = DLY_NONE;
+	if(Continuation == NULL){ return(result);}
+	if(Microseconds == 0){ Microseconds = 1;}
+
+	uint32_t primask = __get_PRIMASK();
+	__disable_irq();
+	for(uint32_t ch=0; ch<DLY_CHANNELS; ch++){
+		if(DlyBusy & (1 << ch)){ continue;}
+
+		uint32_t offset = Microseconds & 0xFFFF;
+		uint32_t rounds = Microseconds >> 16;
+		if(offset == 0){				// exact multiple of the period: the last one
+			offset = 0x10000;			// is waited by the compare itself (CCR = start)
+			rounds--;
+		}
+
+		DlySlots[ch].Continuation = Continuation;
+		DlySlots[ch].Context = Context;
+		DlySlots[ch].Rounds = rounds;
+		DlyBusy |= (1 << ch);
+
+		// clear a stale flag first: clearing after the compare could drop an early match
+		DLY_TIMER->SR = ~(TIM_SR_CC1IF << ch);
+		uint16_t start = (uint16_t)DLY_TIMER->CNT;
+		*DLY_Compare(ch) = (uint16_t)(start + offset);
+		DLY_TIMER->DIER |= (TIM_DIER_CC1IE << ch);
+
+		// a very short delay may have elapsed before the compare was written
+		if((rounds == 0) && ((uint16_t)(DLY_TIMER->CNT - start) >= offset)){
+			DLY_TIMER->DIER &= ~(TIM_DIER_CC1IE << ch);
+			DlyReady |= (1 << ch);
+		}
+		result = ((uint32_t)DlySlots[ch].Generation << DLY_GENERATION_SHIFT) | ch;
+		break;
+	}
+	__set_PRIMASK(primask);
+	return(result);
+}
+
+//------------------------------------------------------------------------------
+uint32_t DLY_DeferMs(uint32_t Milliseconds, DLY_Continuation Continuation, void* Context){
+	if(Milliseconds > (0xFFFFFFFF / 1000)){ return(DLY_NONE);}	// would overflow in us
+	return(DLY_Defer(Milliseconds * 1000, Continuation, Context));
+}
+
+//------------------------------------------------------------------------------
+bool DLY_Cancel(uint32_t Handle){
+	bool result = false;
+
+	uint32_t primask = __get_PRIMASK();
+	__disable_irq();
+	uint32_t ch = DLY_Resolve(Handle);
+	if(ch < DLY_CHANNELS){
+		DLY_TIMER->DIER &= ~(TIM_DIER_CC1IE << ch);
+		DLY_TIMER->SR = ~(TIM_SR_CC1IF << ch);
+		DLY_Release(ch);
+		result = true;
+	}
+	__set_PRIMASK(primask);
+	return(result);
+}
+
+//------------------------------------------------------------------------------
+uint32_t DLY_Dispatch(){
+	uint32_t result = 0;
+
+	while(DlyReady){
+		uint32_t primask = __get_PRIMASK();
+		__disable_irq();
+		uint32_t ch = 31 - __CLZ(DlyReady);
+		DLY_Continuation continuation = DlySlots[ch].Continuation;
+		void* context = DlySlots[ch].Context;
+		DLY_Release(ch);
+		__set_PRIMASK(primask);
+
+		// the channel is already free, so the continuation may defer again
+		continuation(context);
+		result++;
+	}
+	return(result);
+}
+
+//------------------------------------------------------------------------------
+bool DLY_IsPending(){
+	return(DlyBusy != 0);
+}
+
+//------------------------------------------------------------------------------
+void DLY_Idle(bool (*IsIdle)(void)){
+	// WFI wakes up on any pending interrupt, even with PRIMASK set
+	uint32_t primask = __get_PRIMASK();
+	__disable_irq();
+	if((DlyReady == 0) && ((IsIdle == NULL) || IsIdle())){
+		__DSB();
+		__WFI();
+	}
+	__set_PRIMASK(primask);
+}
+
+//------------------------------------------------------------------------------
+extern "C" void DLY_Handler(void){
+	// CCxIF (SR) and CCxIE (DIER) share the same bit positions
+	uint32_t flags = DLY_TIMER->SR & DLY_TIMER->DIER & (TIM_SR_CC1IF * 0x0F);
+
+	for(uint32_t ch=0; ch<DLY_CHANNELS; ch++){
+		if(!(flags & (TIM_SR_CC1IF << ch))){ continue;}
+		DLY_TIMER->SR = ~(TIM_SR_CC1IF << ch);
+
+		if(DlySlots[ch].Rounds){
+			DlySlots[ch].Rounds--;		// same compare value, one more full period
+		} else {
+			DLY_TIMER->DIER &= ~(TIM_DIER_CC1IE << ch);
+			DlyReady |= (1 << ch);
+		}
+	}
+}
+
+//==============================================================================
@@ -118,11 +118,11 @@ void DMA_ClearInterrupts(DMA_Channel_TypeDef* CH){
 }
 
 //------------------------------------------------------------------------------
-// wait for DMA channel "available" (no undergoing transfer)
+// wait for DMA channel "available" (no undergoing transfer); polls the
+// channel registers, not the TC/TE flags, which the channel ISR may clear
+// first. A transfer error disables the channel (EN cleared by hardware).
 void DMA_WaitFreeChannel(DMA_Channel_TypeDef* CH){
-    if(CH->CCR & DMA_CCR_EN){
-        while(DMA_CheckInterrupts(CH, DMA_ISR_TCIF1)){}
-    }
+    while((CH->CCR & DMA_CCR_EN) && (CH->CNDTR != 0)){}
 }
 
 //------------------------------------------------------------------------------
@@ -136,11 +136,38 @@ bool DMA_Move(DMA_Channel_TypeDef* Channel, uint8_t* Paddr, uint8_t* Maddr, uint
             Channel->CPAR = (uint32_t)Paddr;
             Channel->CMAR = (uint32_t)Maddr;
             Channel->CNDTR = N;
-            Channel->CCR = (DMA_CCR_RECEIVE_BYTES | DMA_CCR_EN);
+            DMA_ClearInterrupts(Channel, DMA_IFCR_ALL);
+            Channel->CCR = (DMA_CCR_MOVE_BYTES | DMA_CCR_EN);
             result = true;
         }
     }
     return(result);
 }
 
+//------------------------------------------------------------------------------
+// peripheral transfer (the peripheral's own request paces it)
+bool DMA_Start(DMA_Channel_TypeDef* Channel, volatile void* Paddr, const void* Maddr, uint16_t N, uint32_t Config){
+    bool result = false;
+
+    if((Channel != NULL)&& !(Channel->CCR & DMA_CCR_EN)){
+        if((Paddr!= NULL)&&(Maddr!=NULL)&&(N != 0)){
+            Channel->CPAR = (uint32_t)Paddr;
+            Channel->CMAR = (uint32_t)Maddr;
+            Channel->CNDTR = N;
+            DMA_ClearInterrupts(Channel, DMA_IFCR_ALL);
+            Channel->CCR = (Config & ~DMA_CCR_EN);
+            Channel->CCR = (Config | DMA_CCR_EN);
+            result = true;
+        }
+    }
+    return(result);
+}
+
+//------------------------------------------------------------------------------
+uint16_t DMA_Stop(DMA_Channel_TypeDef* Channel){
+    Channel->CCR &= ~DMA_CCR_EN;
+    DMA_ClearInterrupts(Channel, DMA_IFCR_ALL);
+    return((uint16_t)Channel->CNDTR);
+}
+
 //==============================================================================
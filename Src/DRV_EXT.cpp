@@ -0,0 +1,213 @@
+//==============================================================================
+#include "DRV_EXT.h"
+#include "DRV_IO.h"
+#include "DRV_SSR.h"
+#include "DRV_TMW.h"
+
+//------------------------------------------------------------------------------
+struct EXT_Line{
+	EXT_Callback Callback;
+	void* Context;
+	volatile uint32_t Count;	// events served
+	volatile uint32_t Coalesced;	// holdoff windows that swallowed edges
+	uint32_t Timer;				// holdoff timer (TMW_INVALID when the line is unmasked)
+	uint16_t Holdoff;			// ms, 0 = no coalescing
+	uint8_t Level;				// input level when the holdoff started
+	EXT_Stamps* Stamps;			// edge timestamps (optional)
+	volatile uint32_t* Input;	// IDR of the line's port, for the stamps
+};
+
+static EXT_Line ExtLines[EXT_LINES];
+
+//------------------------------------------------------------------------------
+// lines served by each EXTI vector
+static inline uint32_t EXT_GroupMask(uint32_t IRQn){
+	if(IRQn <= (uint32_t)EXTI4_IRQn){ return((uint32_t)1 << (IRQn - EXTI0_IRQn));}
+	if(IRQn == (uint32_t)EXTI9_5_IRQn){ return(0x03E0);}
+	return(0xFC00);
+}
+
+//------------------------------------------------------------------------------
+static inline uint32_t EXT_ReadLevel(uint32_t Line){
+	return((IO_GetPort(IO_GetExtendedIT(Line))->IDR >> Line) & 1);
+}
+
+// level after the edge being served: a single-edge trigger tells it exactly,
+// the input is only sampled when both edges are enabled
+static inline uint32_t EXT_EdgeLevel(EXT_Line* l, uint32_t Line, uint32_t Bit){
+	uint32_t rising = EXTI->RTSR & Bit;
+	if(rising && (EXTI->FTSR & Bit)){ return((*l->Input >> Line) & 1);}
+	return(rising? 1 : 0);
+}
+
+static inline void EXT_SetMask(uint32_t Bit, bool Enabled){
+	uint32_t primask = __get_PRIMASK();
+	__disable_irq();
+	if(Enabled){ EXTI->IMR |= Bit;}
+	else { EXTI->IMR &= ~Bit;}
+	__set_PRIMASK(primask);
+}
+
+//------------------------------------------------------------------------------
+// end of holdoff (TMW_Tick context): re-enable the line, replaying a missed edge
+static void EXT_Release(uint32_t, void*, uint32_t Line){
+	EXT_Line* l = &ExtLines[Line];
+	uint32_t bit = (uint32_t)1 << Line;
+	l->Timer = TMW_INVALID;
+
+	uint32_t level = EXT_ReadLevel(Line);
+	if(EXTI->PR & bit){
+		l->Coalesced++;
+	} else if(level != l->Level){
+		uint32_t triggers = level? EXTI->RTSR : EXTI->FTSR;
+		if(triggers & bit){ EXTI->SWIER = bit;}
+		l->Coalesced++;
+	}
+	EXT_SetMask(bit, true);
+}
+
+// start of holdoff (interrupt context)
+static void EXT_Hold(uint32_t Line){
+	EXT_Line* l = &ExtLines[Line];
+	uint32_t bit = (uint32_t)1 << Line;
+
+	EXT_SetMask(bit, false);
+	l->Level = EXT_ReadLevel(Line);
+	l->Timer = TMW_Arm(l->Holdoff, EXT_Release, NULL, Line);
+	if(l->Timer == TMW_INVALID){ EXT_SetMask(bit, true);}		// no timer left: no coalescing
+}
+
+//------------------------------------------------------------------------------
+bool EXT_Attach(uint32_t Line, EXT_Callback Callback, void* Context){
+	if(Line >= EXT_LINES){ return(false);}
+
+	uint32_t primask = __get_PRIMASK();
+	__disable_irq();
+	ExtLines[Line].Context = Context;
+	ExtLines[Line].Callback = Callback;
+	ExtLines[Line].Count = 0;
+	ExtLines[Line].Coalesced = 0;
+	__set_PRIMASK(primask);
+
+	SSR_Allocate((uint32_t)EXT_Handler, SSR_VECTOR(IO_GetIrqNumber(Line)));
+	return(true);
+}
+
+//------------------------------------------------------------------------------
+void EXT_Detach(uint32_t Line){
+	if(Line < EXT_LINES){ ExtLines[Line].Callback = NULL;}
+}
+
+//------------------------------------------------------------------------------
+bool EXT_SetHoldoff(uint32_t Line, uint32_t Milliseconds){
+	if(Line >= EXT_LINES){ return(false);}
+	if(Milliseconds > 0xFFFF){ Milliseconds = 0xFFFF;}
+	ExtLines[Line].Holdoff = Milliseconds;
+	return(true);
+}
+
+//------------------------------------------------------------------------------
+uint32_t EXT_GetCount(uint32_t Line){
+	return((Line < EXT_LINES)? ExtLines[Line].Count : 0);
+}
+
+//------------------------------------------------------------------------------
+uint32_t EXT_GetCoalesced(uint32_t Line){
+	return((Line < EXT_LINES)? ExtLines[Line].Coalesced : 0);
+}
+
+//------------------------------------------------------------------------------
+bool EXT_SetTimestamps(GPIO_TypeDef* Port, IO_Config* PinConfig, EXT_Stamps* Ring){
+	uint32_t line = PinConfig->Pin;
+	if((line >= EXT_LINES) || (Port == NULL)){ return(false);}
+
+	static_assert((EXT_STAMPS >= 2) && ((EXT_STAMPS & (EXT_STAMPS - 1)) == 0), "EXT_STAMPS must be a power of two");
+	CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+	DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+	if(Ring != NULL){ Ring->Head = 0;}
+	uint32_t primask = __get_PRIMASK();
+	__disable_irq();
+	ExtLines[line].Input = &Port->IDR;
+	ExtLines[line].Stamps = Ring;
+	__set_PRIMASK(primask);
+
+	SSR_Allocate((uint32_t)EXT_Handler, SSR_VECTOR(IO_GetIrqNumber(line)));
+	return(true);
+}
+
+//------------------------------------------------------------------------------
+bool EXT_GetMeasure(uint32_t Line, EXT_Measure& Result){
+	uint32_t stamps[EXT_STAMPS];
+	uint32_t head, n;
+
+	Result = EXT_Measure();
+	if((Line >= EXT_LINES) || (ExtLines[Line].Stamps == NULL)){ return(false);}
+
+	// snapshot, oldest first
+	uint32_t primask = __get_PRIMASK();
+	__disable_irq();
+	EXT_Stamps* ring = ExtLines[Line].Stamps;
+	head = ring->Head;
+	n = (head < EXT_STAMPS)? head : EXT_STAMPS;
+	for(uint32_t i=0; i<n; i++){ stamps[i] = ring->Stamps[(head - n + i) & (EXT_STAMPS - 1)];}
+	__set_PRIMASK(primask);
+	if(n < 2){ return(false);}
+	Result.Edges = n;
+
+	// period: between the first and the last edge of the newest edge's direction
+	uint32_t level = stamps[n - 1] & 1;
+	uint32_t first = n, periods = 0;
+	for(uint32_t i=0; i<n; i++){
+		if((stamps[i] & 1) != level){ continue;}
+		if(first == n){ first = i;}
+		else { periods++;}
+	}
+	if(periods){ Result.Period = ((stamps[n - 1] & ~1) - (stamps[first] & ~1)) / periods;}
+
+	// high and low times: between consecutive edges of opposite directions
+	uint64_t high = 0, low = 0;
+	uint32_t highs = 0, lows = 0;
+	for(uint32_t i=1; i<n; i++){
+		if((stamps[i] & 1) == (stamps[i - 1] & 1)){ continue;}
+		uint32_t width = (stamps[i] & ~1) - (stamps[i - 1] & ~1);
+		if(stamps[i - 1] & 1){ high += width; highs++;}
+		else { low += width; lows++;}
+	}
+	if(highs){ Result.High = (uint32_t)(high / highs);}
+	if(lows){ Result.Low = (uint32_t)(low / lows);}
+	if(Result.High && Result.Low){
+		if(Result.Period == 0){ Result.Period = Result.High + Result.Low;}
+		Result.Duty = (uint32_t)(((uint64_t)Result.High * 1000) / (Result.High + Result.Low));
+	}
+	if(Result.Period){ Result.Frequency = (uint32_t)(((uint64_t)SystemCoreClock * 1000) / Result.Period);}
+	return(true);
+}
+
+//------------------------------------------------------------------------------
+extern "C" void EXT_Handler(void){
+	uint32_t group = EXT_GroupMask((__get_IPSR() & 0x1FF) - 16);
+	uint32_t pending;
+
+	while((pending = (EXTI->PR & EXTI->IMR & group)) != 0){
+		do{
+			uint32_t line = 31 - __CLZ(pending);
+			uint32_t bit = (uint32_t)1 << line;
+			pending ^= bit;
+			EXTI->PR = bit;						// write-1-to-clear: this line only
+
+			// stamped per line, as it is acknowledged (see EXT_SetTimestamps())
+			EXT_Line* l = &ExtLines[line];
+			EXT_Stamps* r = l->Stamps;
+			if(r != NULL){
+				uint32_t now = DWT->CYCCNT & ~(uint32_t)1;
+				r->Stamps[r->Head++ & (EXT_STAMPS - 1)] = now | EXT_EdgeLevel(l, line, bit);
+			}
+			l->Count++;
+			if(l->Callback != NULL){ l->Callback(line, l->Context);}
+			if(l->Holdoff){ EXT_Hold(line);}
+		}while(pending);
+	}
+}
+
+//==============================================================================
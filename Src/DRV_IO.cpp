@@ -3,6 +3,8 @@
 
 IO_Pinout pins;
 
+static uint8_t IoExtPriority[16];       // 0x10 | level of each EXTI line, 0 for the default
+
 //------------------------------------------------------------------------------
 // return the port index (0x000000PP)
 uint32_t GetPortIndex(GPIO_TypeDef* p){
@@ -59,41 +61,81 @@ GPIO_TypeDef* IO_PortClockOn(uint32_t portindex){
     }
 }
 
+//------------------------------------------------------------------------------
+// merges one pin into the CRL:CRH images and the ODR set/reset masks
+static void IO_ComposePin(uint32_t* CR, uint32_t& Set, uint32_t& Reset, uint32_t Pin, uint32_t Mode){
+    uint32_t offset = (Pin & 0x07) * IO_FIELD_MODE;
+    uint32_t bit = ((uint32_t)1 << Pin);
+
+    // pull-up is a pull-down input with the ODR bit set; everything else starts low
+    if(Mode == io_In_PullUp){ Mode = io_In_PullDown; Set |= bit; Reset &= ~bit;}
+    else { Reset |= bit; Set &= ~bit;}
+
+    CR[Pin>>3] = (CR[Pin>>3] & ~(IO_MASK_MODE << offset)) | (Mode << offset);
+}
+
+//------------------------------------------------------------------------------
+// writes the images: the output levels first (BSRR), then each CRx at most once
+static void IO_CommitPort(GPIO_TypeDef* Port, uint32_t* CR, uint32_t Set, uint32_t Reset){
+    uint32_t pins = Set | Reset;
+    Port->BSRR = Set | (Reset << 16);
+    if(pins & 0x00FF){ Port->CRL = CR[0];}
+    if(pins & 0xFF00){ Port->CRH = CR[1];}
+}
+
+//------------------------------------------------------------------------------
+static bool IO_IsInterruptInput(const IO_Config* PinConfig){
+    return(((bool)PinConfig->Int)&&
+        ((PinConfig->Mode==io_In_Floating)||
+            (PinConfig->Mode==io_In_PullDown)||
+                (PinConfig->Mode==io_In_PullUp)));
+}
+
 //------------------------------------------------------------------------------
 // setup and initializes a single I/O port pin
 void IO_PinInit(GPIO_TypeDef* Port, IO_Config* PinConfig){
-    int32_t offset = 0;
-    uint32_t pin = PinConfig->Pin;
-    
-    // enable clock
-	IO_PortClockEnable(Port);
+    IO_PortConfig(Port, PinConfig, 1);
+}
 
-    uint32_t* MODER = (uint32_t*)&Port->CRL;
-    
-    if(pin>15){ return;}
-    else if(pin>7){ MODER = (uint32_t*)&Port->CRH; pin -= 8;}
+//------------------------------------------------------------------------------
+// setup a list of pins of the same port, writing each register once
+void IO_PortConfig(GPIO_TypeDef* Port, IO_Config* Pins, uint32_t Count){
+    uint32_t set = 0, reset = 0;
 
-    offset = (pin * IO_FIELD_MODE);
-    
-    *MODER &= ~(IO_MASK_MODE << offset);
-    
-    uint32_t mode = PinConfig->Mode;
+    // enable clock
+    IO_PortClockEnable(Port);
 
-    Port->ODR &= ~((uint32_t)1 << PinConfig->Pin);
+    uint32_t cr[2] = {Port->CRL, Port->CRH};
+    for(uint32_t i=0; i<Count; i++){
+        if(Pins[i].Pin>15){ continue;}
+        IO_ComposePin(cr, set, reset, Pins[i].Pin, Pins[i].Mode);
+    }
+    IO_CommitPort(Port, cr, set, reset);
 
-    if(PinConfig->Mode == io_In_PullUp){
-    	mode = io_In_PullDown;
-    	Port->ODR |= ((uint32_t)1 << PinConfig->Pin);
+    for(uint32_t i=0; i<Count; i++){
+        if((Pins[i].Pin<=15) && IO_IsInterruptInput(&Pins[i])){ IO_SetExtendedIT(Port, &Pins[i]);}
     }
+}
 
-    *MODER |= (mode << offset);
+//------------------------------------------------------------------------------
+// setup every pin in Mask with the same configuration (PinConfig->Pin is ignored)
+void IO_PortInit(GPIO_TypeDef* Port, uint16_t Mask, IO_Config* PinConfig){
+    uint32_t set = 0, reset = 0;
 
+    // enable clock
+    IO_PortClockEnable(Port);
 
-    if(((bool)PinConfig->Int)&&
-        ((PinConfig->Mode==io_In_Floating)||
-            (PinConfig->Mode==io_In_PullDown)||
-                (PinConfig->Mode==io_In_PullUp))){
-                    IO_SetExtendedIT(Port, PinConfig);
+    uint32_t cr[2] = {Port->CRL, Port->CRH};
+    for(uint32_t pin=0; pin<16; pin++){
+        if(Mask & (1 << pin)){ IO_ComposePin(cr, set, reset, pin, PinConfig->Mode);}
+    }
+    IO_CommitPort(Port, cr, set, reset);
+
+    if(IO_IsInterruptInput(PinConfig)){
+        IO_Config line = *PinConfig;
+        for(uint32_t pin=0; pin<16; pin++){
+            if(Mask & (1 << pin)){ line.Pin = pin; IO_SetExtendedIT(Port, &line);}
+        }
     }
 }
 
@@ -108,6 +150,20 @@ uint32_t IO_GetExtendedIT(uint32_t pin) {
     return(result);
 }
 
+//------------------------------------------------------------------------------
+// a shared vector runs at the highest priority among its enabled lines
+static uint32_t IO_GetExtendedPriority(uint32_t pin){
+    uint32_t group = (pin < 5)? ((uint32_t)1 << pin) : (pin < 10)? 0x03E0 : 0xFC00;
+    uint32_t lines = (EXTI->IMR & group) | ((uint32_t)1 << pin);
+    uint32_t result = SYS_PRIORITY_LOWEST;
+    for(uint32_t i=0; i<16; i++){
+        if(!(lines & ((uint32_t)1 << i))){ continue;}
+        uint32_t level = IoExtPriority[i]? (IoExtPriority[i] & 0x0F) : SYS_PRIORITY_NORMAL;
+        if(level < result){ result = level;}
+    }
+    return(result);
+}
+
 //------------------------------------------------------------------------------
 // setup input pin as "external interrupt"
 void IO_SetExtendedIT(GPIO_TypeDef* Porta, IO_Config* Pino) {
@@ -139,11 +195,23 @@ void IO_SetExtendedIT(GPIO_TypeDef* Porta, IO_Config* Pino) {
 
     // configure NVIC for Extended Interrupt
     IRQn_Type EXTINT_IRQn = IO_GetIrqNumber(Pino->Pin);
-    uint32_t p = NVIC_EncodePriority(NVIC_PriorityGroup_4, SYS_PRIORITY_NORMAL, 0);
+    uint32_t p = NVIC_EncodePriority(NVIC_PriorityGroup_4, IO_GetExtendedPriority(Pino->Pin), 0);
     NVIC_SetPriority(EXTINT_IRQn, p);                                       // (5)
     NVIC_EnableIRQ(EXTINT_IRQn);                                            // (6)
 }
 
+//------------------------------------------------------------------------------
+void IO_SetExtendedPriority(uint32_t Line, uint32_t Priority) {
+    if(Line > 15){ return;}
+    IoExtPriority[Line] = (uint8_t)(0x10 | (Priority & 0x0F));
+
+    // already enabled: reprogram its (possibly shared) vector
+    if(EXTI->IMR & (1 << Line)){
+        uint32_t p = NVIC_EncodePriority(NVIC_PriorityGroup_4, IO_GetExtendedPriority(Line), 0);
+        NVIC_SetPriority(IO_GetIrqNumber(Line), p);
+    }
+}
+
 //------------------------------------------------------------------------------
 void IO_ResetExtendedIT(GPIO_TypeDef* Porta, IO_Config* Pino) {
 
@@ -171,7 +239,7 @@ void IO_UnmaskExtendedIT(IO_Config* Pino) {
 
 //------------------------------------------------------------------------------
 void IO_ClearPendingExtendedIT(IO_Config* Pino) {
-    EXTI->PR |= (uint16_t)(1 << Pino->Pin);
+    EXTI->PR = (uint32_t)1 << Pino->Pin;                                    // write-1-to-clear: this line only
 }
 
 //------------------------------------------------------------------------------
@@ -193,4 +261,153 @@ IRQn_Type IO_GetIrqNumber(uint32_t pin){
     return(result);
 }
 
+//------------------------------------------------------------------------------
+// peripheral pinmux table (IO_PinConfig)
+#define IO_PINMUX_PINS      4
+
+struct IO_Pinmux{
+    uint16_t ConfigId;                          // __<PERIPHERAL>_<PINOUT> (| __MASK_FULL / __MASK_SLAVE)
+    bool Jtag;                                  // uses JTAG pins: SW-DP only
+    uint32_t Clear;                             // AFIO->MAPR field
+    uint32_t Set;                               // AFIO->MAPR value
+    struct{
+        uint16_t Pin;                           // encoded Port:Pin (__NOTAV ends the list)
+        uint8_t Mode;                           // io_modes
+    } Pins[IO_PINMUX_PINS];
+};
+
+#define IO_AF               io_Alt_PushPull_50MHz
+#define IO_OD               io_Alt_OpenDrain_50MHz
+#define IO_IN               io_In_Floating
+#define IO_PU               io_In_PullUp
+#define IO_NONE             {__NOTAV, 0}
+
+static const IO_Pinmux IoPinmux[] = {
+    // USART: TX, RX
+    {__USART1_STANDARD, false, AFIO_MAPR_USART1_REMAP, 0,
+        {{__PORTA|__PIN9, IO_AF}, {__PORTA|__PIN10, IO_PU}, IO_NONE, IO_NONE}},
+    {__USART1_REMAPPED, false, AFIO_MAPR_USART1_REMAP, AFIO_MAPR_USART1_REMAP,
+        {{__PORTB|__PIN6, IO_AF}, {__PORTB|__PIN7, IO_PU}, IO_NONE, IO_NONE}},
+    {__USART2_STANDARD, false, AFIO_MAPR_USART2_REMAP, 0,
+        {{__PORTA|__PIN2, IO_AF}, {__PORTA|__PIN3, IO_PU}, IO_NONE, IO_NONE}},
+    {__USART2_REMAPPED, false, AFIO_MAPR_USART2_REMAP, AFIO_MAPR_USART2_REMAP,
+        {{__PORTD|__PIN5, IO_AF}, {__PORTD|__PIN6, IO_PU}, IO_NONE, IO_NONE}},
+    {__USART3_STANDARD, false, AFIO_MAPR_USART3_REMAP, 0,
+        {{__PORTB|__PIN10, IO_AF}, {__PORTB|__PIN11, IO_PU}, IO_NONE, IO_NONE}},
+    {__USART3_REMAPPED, false, AFIO_MAPR_USART3_REMAP, AFIO_MAPR_USART3_REMAP_PARTIALREMAP,
+        {{__PORTC|__PIN10, IO_AF}, {__PORTC|__PIN11, IO_PU}, IO_NONE, IO_NONE}},
+    {__USART3_REMAPPED|__MASK_FULL, false, AFIO_MAPR_USART3_REMAP, AFIO_MAPR_USART3_REMAP_FULLREMAP,
+        {{__PORTD|__PIN8, IO_AF}, {__PORTD|__PIN9, IO_PU}, IO_NONE, IO_NONE}},
+#ifdef UART4
+    {__UART4_STANDARD, false, 0, 0,
+        {{__PORTC|__PIN10, IO_AF}, {__PORTC|__PIN11, IO_PU}, IO_NONE, IO_NONE}},
+#endif
+#ifdef UART5
+    {__UART5_STANDARD, false, 0, 0,
+        {{__PORTC|__PIN12, IO_AF}, {__PORTD|__PIN2, IO_PU}, IO_NONE, IO_NONE}},
+#endif
+
+    // CAN: TX, RX
+#ifdef AFIO_MAPR_CAN_REMAP
+    {__CAN1_STANDARD, false, AFIO_MAPR_CAN_REMAP, AFIO_MAPR_CAN_REMAP_REMAP1,
+        {{__PORTA|__PIN12, IO_AF}, {__PORTA|__PIN11, IO_PU}, IO_NONE, IO_NONE}},
+    {__CAN1_REMAPPED1, false, AFIO_MAPR_CAN_REMAP, AFIO_MAPR_CAN_REMAP_REMAP2,
+        {{__PORTB|__PIN9, IO_AF}, {__PORTB|__PIN8, IO_PU}, IO_NONE, IO_NONE}},
+    {__CAN1_REMAPPED2, false, AFIO_MAPR_CAN_REMAP, AFIO_MAPR_CAN_REMAP_REMAP3,
+        {{__PORTD|__PIN1, IO_AF}, {__PORTD|__PIN0, IO_PU}, IO_NONE, IO_NONE}},
+#endif
+#ifdef AFIO_MAPR_CAN2_REMAP
+    {__CAN2_STANDARD, false, AFIO_MAPR_CAN2_REMAP, 0,
+        {{__PORTB|__PIN13, IO_AF}, {__PORTB|__PIN12, IO_PU}, IO_NONE, IO_NONE}},
+    {__CAN2_REMAPPED, false, AFIO_MAPR_CAN2_REMAP, AFIO_MAPR_CAN2_REMAP,
+        {{__PORTB|__PIN6, IO_AF}, {__PORTB|__PIN5, IO_PU}, IO_NONE, IO_NONE}},
+#endif
+
+    // SPI master: SCK, MOSI, MISO (NSS is left to the application)
+    // SPI slave: SCK, MOSI, MISO, NSS
+    {__SPI1_STANDARD, false, AFIO_MAPR_SPI1_REMAP, 0,
+        {{__PORTA|__PIN5, IO_AF}, {__PORTA|__PIN7, IO_AF}, {__PORTA|__PIN6, IO_IN}, IO_NONE}},
+    {__SPI1_STANDARD|__MASK_SLAVE, false, AFIO_MAPR_SPI1_REMAP, 0,
+        {{__PORTA|__PIN5, IO_IN}, {__PORTA|__PIN7, IO_IN}, {__PORTA|__PIN6, IO_AF}, {__PORTA|__PIN4, IO_IN}}},
+    {__SPI1_REMAPPED, true, AFIO_MAPR_SPI1_REMAP, AFIO_MAPR_SPI1_REMAP,
+        {{__PORTB|__PIN3, IO_AF}, {__PORTB|__PIN5, IO_AF}, {__PORTB|__PIN4, IO_IN}, IO_NONE}},
+    {__SPI1_REMAPPED|__MASK_SLAVE, true, AFIO_MAPR_SPI1_REMAP, AFIO_MAPR_SPI1_REMAP,
+        {{__PORTB|__PIN3, IO_IN}, {__PORTB|__PIN5, IO_IN}, {__PORTB|__PIN4, IO_AF}, {__PORTA|__PIN15, IO_IN}}},
+    {__SPI2_STANDARD, false, 0, 0,
+        {{__PORTB|__PIN13, IO_AF}, {__PORTB|__PIN15, IO_AF}, {__PORTB|__PIN14, IO_IN}, IO_NONE}},
+    {__SPI2_STANDARD|__MASK_SLAVE, false, 0, 0,
+        {{__PORTB|__PIN13, IO_IN}, {__PORTB|__PIN15, IO_IN}, {__PORTB|__PIN14, IO_AF}, {__PORTB|__PIN12, IO_IN}}},
+#ifdef SPI3
+    {__SPI3_STANDARD, true, 0, 0,
+        {{__PORTB|__PIN3, IO_AF}, {__PORTB|__PIN5, IO_AF}, {__PORTB|__PIN4, IO_IN}, IO_NONE}},
+    {__SPI3_STANDARD|__MASK_SLAVE, true, 0, 0,
+        {{__PORTB|__PIN3, IO_IN}, {__PORTB|__PIN5, IO_IN}, {__PORTB|__PIN4, IO_AF}, {__PORTA|__PIN15, IO_IN}}},
+#endif
+#ifdef AFIO_MAPR_SPI3_REMAP
+    {__SPI3_REMAPPED, false, AFIO_MAPR_SPI3_REMAP, AFIO_MAPR_SPI3_REMAP,
+        {{__PORTC|__PIN10, IO_AF}, {__PORTC|__PIN12, IO_AF}, {__PORTC|__PIN11, IO_IN}, IO_NONE}},
+    {__SPI3_REMAPPED|__MASK_SLAVE, false, AFIO_MAPR_SPI3_REMAP, AFIO_MAPR_SPI3_REMAP,
+        {{__PORTC|__PIN10, IO_IN}, {__PORTC|__PIN12, IO_IN}, {__PORTC|__PIN11, IO_AF}, {__PORTA|__PIN4, IO_IN}}},
+#endif
+
+    // I2C: SCL, SDA
+    {__I2C1_STANDARD, false, AFIO_MAPR_I2C1_REMAP, 0,
+        {{__PORTB|__PIN6, IO_OD}, {__PORTB|__PIN7, IO_OD}, IO_NONE, IO_NONE}},
+    {__I2C1_REMAPPED, false, AFIO_MAPR_I2C1_REMAP, AFIO_MAPR_I2C1_REMAP,
+        {{__PORTB|__PIN8, IO_OD}, {__PORTB|__PIN9, IO_OD}, IO_NONE, IO_NONE}},
+    {__I2C2_STANDARD, false, 0, 0,
+        {{__PORTB|__PIN10, IO_OD}, {__PORTB|__PIN11, IO_OD}, IO_NONE, IO_NONE}},
+};
+
+// SWJ_CFG is write-only (reads back undefined): last value written
+static uint32_t IoSwj = 0;
+
+//------------------------------------------------------------------------------
+// single MAPR store: remap field plus the SWJ_CFG copy
+static void IO_WriteRemap(uint32_t Clear, uint32_t Set){
+    RCC->APB2ENR |= RCC_APB2ENR_AFIOEN;
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    AFIO->MAPR = (AFIO->MAPR & ~(AFIO_MAPR_SWJ_CFG | Clear)) | Set | IoSwj;
+    __set_PRIMASK(primask);
+}
+
+//------------------------------------------------------------------------------
+void IO_SetDebugPort(uint32_t SwjConfig){
+    IoSwj = SwjConfig & AFIO_MAPR_SWJ_CFG;
+    IO_WriteRemap(0, 0);
+}
+
+//------------------------------------------------------------------------------
+bool IO_PinConfig(uint16_t ConfigId){
+    const IO_Pinmux* entry = NULL;
+    for(uint32_t i=0; i<(sizeof(IoPinmux)/sizeof(IoPinmux[0])); i++){
+        if(IoPinmux[i].ConfigId == ConfigId){ entry = &IoPinmux[i]; break;}
+    }
+    if(entry == NULL){ return(false);}
+
+    // release the JTAG pins (keeping SW-DP) unless the debug port is already off
+    if(entry->Jtag && (IoSwj < AFIO_MAPR_SWJ_CFG_JTAGDISABLE)){ IoSwj = AFIO_MAPR_SWJ_CFG_JTAGDISABLE;}
+    IO_WriteRemap(entry->Clear, entry->Set);
+
+    // one IO_PortConfig() per port used by the pinout
+    uint32_t done = 0;
+    for(uint32_t i=0; (i<IO_PINMUX_PINS) && (entry->Pins[i].Pin != __NOTAV); i++){
+        uint32_t port = entry->Pins[i].Pin & __MASK_PIN;
+        if(done & (1 << (port >> 8))){ continue;}
+        done |= (1 << (port >> 8));
+
+        IO_Config pins[IO_PINMUX_PINS] = {};
+        uint32_t count = 0;
+        for(uint32_t j=i; (j<IO_PINMUX_PINS) && (entry->Pins[j].Pin != __NOTAV); j++){
+            if((entry->Pins[j].Pin & __MASK_PIN) != port){ continue;}
+            pins[count].Pin = entry->Pins[j].Pin & __MASK_PORT;
+            pins[count].Mode = entry->Pins[j].Mode;
+            count++;
+        }
+        IO_PortConfig(IO_GetPort(port), pins, count);
+    }
+    return(true);
+}
+
 //==============================================================================
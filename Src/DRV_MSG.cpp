@@ -0,0 +1,125 @@
+//==============================================================================
+#include "DRV_MSG.h"
+
+#ifdef SSR_TRACE
+	#include "DRV_TRC.h"
+#endif
+
+//------------------------------------------------------------------------------
+template <uint32_t N>
+struct MSG_Lane{
+	MpscRing<NMESSAGE, N> Ring;
+	RING_Index HighWater;
+	RING_Index Posted;
+	RING_Index Overflows;
+};
+
+static MSG_Lane<MSG_SIGNAL_SIZE> MsgSignal;
+static MSG_Lane<MSG_NORMAL_SIZE> MsgNormal;
+static MSG_Lane<MSG_LOW_SIZE> MsgLow;
+
+//------------------------------------------------------------------------------
+// counters are shared by all the producers, so they are updated with LDREX/STREX
+static void MSG_Increment(RING_Index* Counter){
+	uint32_t v;
+	do{ v = RING_LoadExclusive(Counter);} while(!RING_StoreExclusive(Counter, v, v + 1));
+}
+
+static void MSG_Maximum(RING_Index* Counter, uint32_t Value){
+	uint32_t v;
+	do{
+		v = RING_LoadExclusive(Counter);
+		if(Value <= v){
+			RING_ClearExclusive();
+			return;
+		}
+	} while(!RING_StoreExclusive(Counter, v, Value));
+}
+
+//------------------------------------------------------------------------------
+template <uint32_t N>
+static bool MSG_Push(MSG_Lane<N>& Lane, const NMESSAGE& Message){
+	if(!Lane.Ring.Push(Message)){
+		MSG_Increment(&Lane.Overflows);
+		return(false);
+	}
+	MSG_Increment(&Lane.Posted);
+	MSG_Maximum(&Lane.HighWater, Lane.Ring.Count());
+	return(true);
+}
+
+template <uint32_t N>
+static void MSG_Snapshot(MSG_Lane<N>& Lane, MSG_LaneStats& Stats){
+	Stats.Capacity = N;
+	Stats.Pending = Lane.Ring.Count();
+	Stats.HighWater = RING_Load(&Lane.HighWater);
+	Stats.Posted = RING_Load(&Lane.Posted);
+	Stats.Overflows = RING_Load(&Lane.Overflows);
+}
+
+template <uint32_t N>
+static void MSG_Reset(MSG_Lane<N>& Lane){
+	RING_Store(&Lane.HighWater, Lane.Ring.Count());
+	RING_Store(&Lane.Posted, 0);
+	RING_Store(&Lane.Overflows, 0);
+}
+
+//------------------------------------------------------------------------------
+bool MSG_Post(uint32_t Lane, const NMESSAGE& Message){
+	bool result = false;
+	#ifdef SSR_TRACE
+		TRC_Record(TRC_KIND_MESSAGE, Message.message, Message.data1, Message.data2);
+	#endif
+	switch(Lane){
+		case MSG_LANE_SIGNAL: result = MSG_Push(MsgSignal, Message); break;
+		case MSG_LANE_NORMAL: result = MSG_Push(MsgNormal, Message); break;
+		case MSG_LANE_LOW: result = MSG_Push(MsgLow, Message); break;
+		default: break;
+	}
+	return(result);
+}
+
+//------------------------------------------------------------------------------
+bool MSG_Get(NMESSAGE& Message){
+	if(MsgSignal.Ring.Pop(Message)){ return(true);}
+	if(MsgNormal.Ring.Pop(Message)){ return(true);}
+	return(MsgLow.Ring.Pop(Message));
+}
+
+//------------------------------------------------------------------------------
+uint32_t MSG_Drain(NMESSAGE* Buffer, uint32_t Max){
+	uint32_t n = 0;
+	if(Buffer == NULL){ return(0);}
+
+	// a lane is only left when it is empty, so signals keep their precedence
+	while((n < Max) && MsgSignal.Ring.Pop(Buffer[n])){ n++;}
+	while((n < Max) && MsgNormal.Ring.Pop(Buffer[n])){ n++;}
+	while((n < Max) && MsgLow.Ring.Pop(Buffer[n])){ n++;}
+	return(n);
+}
+
+//------------------------------------------------------------------------------
+bool MSG_IsEmpty(){
+	return(MsgSignal.Ring.IsEmpty() && MsgNormal.Ring.IsEmpty() && MsgLow.Ring.IsEmpty());
+}
+
+//------------------------------------------------------------------------------
+bool MSG_GetStats(uint32_t Lane, MSG_LaneStats& Stats){
+	bool result = true;
+	switch(Lane){
+		case MSG_LANE_SIGNAL: MSG_Snapshot(MsgSignal, Stats); break;
+		case MSG_LANE_NORMAL: MSG_Snapshot(MsgNormal, Stats); break;
+		case MSG_LANE_LOW: MSG_Snapshot(MsgLow, Stats); break;
+		default: result = false; break;
+	}
+	return(result);
+}
+
+//------------------------------------------------------------------------------
+void MSG_ClearStats(){
+	MSG_Reset(MsgSignal);
+	MSG_Reset(MsgNormal);
+	MSG_Reset(MsgLow);
+}
+
+//==============================================================================
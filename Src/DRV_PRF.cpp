@@ -0,0 +1,131 @@
+//==============================================================================
+#include "DRV_PRF.h"
+
+#ifdef SSR_PROFILE_IRQ
+
+//------------------------------------------------------------------------------
+static_assert(PRF_MAX_SLOTS < PRF_NO_SLOT, "PRF_MAX_SLOTS must leave PRF_NO_SLOT free");
+
+static PRF_Stats PrfSlots[PRF_MAX_SLOTS];
+static uint8_t PrfMap[SSR_MAX_VECTORS];
+static uint32_t PrfUsed = 0;
+static bool PrfReady = false;				// a zeroed map reads as slot 0 everywhere
+
+//------------------------------------------------------------------------------
+static inline uint32_t PRF_GetBin(uint32_t cycles){
+	uint32_t bin = cycles >> PRF_BIN_SHIFT;
+	if(bin){ bin = 32 - __CLZ(bin);}
+	if(bin >= PRF_BINS){ bin = PRF_BINS - 1;}
+	return(bin);
+}
+
+//------------------------------------------------------------------------------
+// the map is emptied once: the vectors already wrapped keep pointing to
+// PRF_Handler, so their slots must outlive a later PRF_Initialize()
+static void PRF_Prepare(){
+	if(PrfReady){ return;}
+	for(uint32_t i=0; i<SSR_MAX_VECTORS; i++){ PrfMap[i] = PRF_NO_SLOT;}
+	PrfUsed = 0;
+	PrfReady = true;
+}
+
+//------------------------------------------------------------------------------
+void PRF_Initialize(){
+	CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+	DWT->CYCCNT = 0;
+	DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+	uint32_t primask = __get_PRIMASK();
+	__disable_irq();
+	PRF_Prepare();
+	__set_PRIMASK(primask);
+	PRF_Clear();
+}
+
+//------------------------------------------------------------------------------
+uint32_t PRF_Wrap(uint32_t IsrAddress, uint32_t VectorIndex){
+	if(VectorIndex >= SSR_MAX_VECTORS){ return(IsrAddress);}
+	PRF_Prepare();
+
+	uint8_t index = PrfMap[VectorIndex];
+	if(index == PRF_NO_SLOT){
+		if(PrfUsed >= PRF_MAX_SLOTS){ return(IsrAddress);}
+		index = (uint8_t)PrfUsed++;
+	}
+
+	PrfSlots[index].Vector = VectorIndex;
+	PrfSlots[index].Isr = IsrAddress;
+	__DMB();
+	PrfMap[VectorIndex] = index;
+	return((uint32_t)PRF_Handler);
+}
+
+//------------------------------------------------------------------------------
+void PRF_Stamp(uint32_t VectorIndex){
+	uint32_t now = DWT->CYCCNT;
+	if((VectorIndex >= SSR_MAX_VECTORS) || !PrfReady){ return;}
+	uint8_t index = PrfMap[VectorIndex];
+	if(index != PRF_NO_SLOT){ PrfSlots[index].Stamp = now | 1;}
+}
+
+//------------------------------------------------------------------------------
+void PRF_Trigger(IRQn_Type IRQn){
+	PRF_Stamp(SSR_VECTOR(IRQn));
+	NVIC_SetPendingIRQ(IRQn);
+}
+
+//------------------------------------------------------------------------------
+PRF_Stats* PRF_GetStats(uint32_t VectorIndex){
+	if((VectorIndex >= SSR_MAX_VECTORS) || !PrfReady){ return(NULL);}
+	uint8_t index = PrfMap[VectorIndex];
+	return((index == PRF_NO_SLOT)? NULL : &PrfSlots[index]);
+}
+
+//------------------------------------------------------------------------------
+void PRF_Clear(){
+	for(uint32_t s=0; s<PRF_MAX_SLOTS; s++){
+		PRF_Stats* p = &PrfSlots[s];
+		p->Stamp = 0;
+		p->Count = 0;
+		p->Samples = 0;
+		p->LatencyMax = 0;
+		p->DurationMax = 0;
+		for(uint32_t b=0; b<PRF_BINS; b++){ p->Latency[b] = 0; p->Duration[b] = 0;}
+	}
+}
+
+//------------------------------------------------------------------------------
+// common entry point of the profiled vectors (the active vector comes from IPSR)
+extern "C" void PRF_Handler(void){
+	uint32_t entry = DWT->CYCCNT;
+	uint8_t index = PrfMap[__get_IPSR() & SCB_ICSR_VECTACTIVE_Msk];
+
+	// vector written with PRF_Handler but never wrapped: no handler to call
+	if(index >= PRF_MAX_SLOTS){
+		__BKPT(0);
+		return;
+	}
+	PRF_Stats* p = &PrfSlots[index];
+
+	uint32_t stamp = p->Stamp;
+	p->Stamp = 0;
+
+	((void(*)(void))p->Isr)();
+
+	uint32_t duration = DWT->CYCCNT - entry;
+
+	p->Count++;
+	p->Duration[PRF_GetBin(duration)]++;
+	if(duration > p->DurationMax){ p->DurationMax = duration;}
+
+	// stamps carry bit 0 set, so that a zero timestamp still counts as valid
+	if(stamp){
+		uint32_t latency = entry - (stamp & ~(uint32_t)1);
+		p->Samples++;
+		p->Latency[PRF_GetBin(latency)]++;
+		if(latency > p->LatencyMax){ p->LatencyMax = latency;}
+	}
+}
+
+#endif
+//==============================================================================
@@ -0,0 +1,159 @@
+//==============================================================================
+#include "DRV_REG.h"
+#include "stm32f1xx.h"
+
+//------------------------------------------------------------------------------
+static constexpr uint32_t REG_HashSize(uint32_t n){
+	uint32_t size = 4;
+	while(size < (2 * n)){ size <<= 1;}
+	return(size);
+}
+
+#define REG_HASH_SIZE				REG_HashSize(REG_CAPACITY)
+#define REG_HASH_MASK				(REG_HASH_SIZE - 1)
+
+static_assert(REG_CAPACITY < REG_NONE, "registry too large for 16 bit indexes");
+
+struct REG_Slot{
+	uint32_t Address;				// 0 when free
+	uint16_t Generation;			// bumped on every release, never 0
+	uint16_t Next;					// free list link
+};
+
+static REG_Slot RegSlots[REG_CAPACITY];
+static uint16_t RegHash[REG_HASH_SIZE];		// address -> slot index (open addressing)
+static uint16_t RegFree = REG_NONE;
+static uint32_t RegCount = 0;
+static bool RegReady = false;				// a zeroed hash reads as full, not empty
+
+//------------------------------------------------------------------------------
+static inline uint32_t REG_Hash(uint32_t Address){
+	uint32_t h = (Address >> 2) * 0x9E3779B1;
+	return((h ^ (h >> 16)) & REG_HASH_MASK);
+}
+
+static inline uint32_t REG_MakeHandle(uint32_t index){
+	return(((uint32_t)RegSlots[index].Generation << REG_GENERATION_SHIFT) | index);
+}
+
+//------------------------------------------------------------------------------
+// hash position of an address (or the empty position where it would go)
+static uint32_t REG_Probe(uint32_t Address){
+	uint32_t pos = REG_Hash(Address);
+	while((RegHash[pos] != REG_NONE) && (RegSlots[RegHash[pos]].Address != Address)){
+		pos = (pos + 1) & REG_HASH_MASK;
+	}
+	return(pos);
+}
+
+//------------------------------------------------------------------------------
+// backward-shift deletion keeps every probe chain unbroken without tombstones
+static void REG_HashRemove(uint32_t pos){
+	uint32_t next = (pos + 1) & REG_HASH_MASK;
+	while(RegHash[next] != REG_NONE){
+		uint32_t home = REG_Hash(RegSlots[RegHash[next]].Address);
+		if(((next - home) & REG_HASH_MASK) >= ((next - pos) & REG_HASH_MASK)){
+			RegHash[pos] = RegHash[next];
+			pos = next;
+		}
+		next = (next + 1) & REG_HASH_MASK;
+	}
+	RegHash[pos] = REG_NONE;
+}
+
+//------------------------------------------------------------------------------
+void REG_Initialize(){
+	uint32_t primask = __get_PRIMASK();
+	__disable_irq();
+	for(uint32_t i=0; i<REG_HASH_SIZE; i++){ RegHash[i] = REG_NONE;}
+	RegFree = REG_NONE;
+	for(uint32_t i=REG_CAPACITY; i>0; i--){
+		REG_Slot* s = &RegSlots[i - 1];
+		s->Address = 0;
+		if(++s->Generation == 0){ s->Generation = 1;}		// handles from before go stale
+		s->Next = RegFree;
+		RegFree = (uint16_t)(i - 1);
+	}
+	RegCount = 0;
+	RegReady = true;
+	__set_PRIMASK(primask);
+}
+
+//------------------------------------------------------------------------------
+uint32_t REG_Register(uint32_t Address){
+	uint32_t result = REG_INVALID;
+	if(Address == 0){ return(result);}
+
+	uint32_t primask = __get_PRIMASK();
+	__disable_irq();
+	if(!RegReady){ REG_Initialize();}
+	uint32_t pos = REG_Probe(Address);
+	if(RegHash[pos] != REG_NONE){
+		result = REG_MakeHandle(RegHash[pos]);
+	} else if(RegFree != REG_NONE){
+		uint16_t index = RegFree;
+		RegFree = RegSlots[index].Next;
+		RegSlots[index].Address = Address;
+		RegHash[pos] = index;
+		RegCount++;
+		result = REG_MakeHandle(index);
+	}
+	__set_PRIMASK(primask);
+	return(result);
+}
+
+//------------------------------------------------------------------------------
+bool REG_Unregister(uint32_t Handle){
+	bool result = false;
+
+	uint32_t primask = __get_PRIMASK();
+	__disable_irq();
+	uint32_t index = REG_GetIndex(Handle);
+	if(index < REG_CAPACITY){
+		REG_Slot* s = &RegSlots[index];
+		REG_HashRemove(REG_Probe(s->Address));
+		s->Address = 0;
+		if(++s->Generation == 0){ s->Generation = 1;}
+		s->Next = RegFree;
+		RegFree = (uint16_t)index;
+		RegCount--;
+		result = true;
+	}
+	__set_PRIMASK(primask);
+	return(result);
+}
+
+//------------------------------------------------------------------------------
+uint32_t REG_Resolve(uint32_t Handle){
+	uint32_t index = REG_GetIndex(Handle);
+	return((index < REG_CAPACITY)? RegSlots[index].Address : (uint32_t)NULL);
+}
+
+//------------------------------------------------------------------------------
+uint32_t REG_Find(uint32_t Address){
+	uint32_t result = REG_INVALID;
+	if((Address == 0) || !RegReady){ return(result);}
+
+	uint32_t primask = __get_PRIMASK();
+	__disable_irq();
+	uint32_t pos = REG_Probe(Address);
+	if(RegHash[pos] != REG_NONE){ result = REG_MakeHandle(RegHash[pos]);}
+	__set_PRIMASK(primask);
+	return(result);
+}
+
+//------------------------------------------------------------------------------
+uint32_t REG_GetIndex(uint32_t Handle){
+	uint32_t index = Handle & REG_INDEX_MASK;
+	if(index >= REG_CAPACITY){ return(REG_CAPACITY);}
+	const REG_Slot* s = &RegSlots[index];
+	if((s->Address == 0) || (s->Generation != (Handle >> REG_GENERATION_SHIFT))){ return(REG_CAPACITY);}
+	return(index);
+}
+
+//------------------------------------------------------------------------------
+uint32_t REG_Count(){
+	return(RegCount);
+}
+
+//==============================================================================
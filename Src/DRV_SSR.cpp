@@ -1,267 +1,596 @@
 //============================================================================//
 #include "DRV_SSR.h"
+#include "DRV_TMW.h"
+#include "DRV_MSG.h"
+#include "DRV_REG.h"
+
+#ifdef SSR_RELOCATE_DMA
+	#include "DRV_DMA.h"
+#endif
+
+#ifdef SSR_PROFILE_IRQ
+	#include "DRV_PRF.h"
+#endif
+
+#ifdef SSR_FLASH_VECTORS
+	#include "SsrVectors.h"
+#endif
+
+#ifdef SSR_TRACE
+	#include "DRV_TRC.h"
+#endif
 
 //------------------------------------------------------------------------------
-extern "C" {
-    //--------------------------------------------------------------------------
-    //void __svc(0x01) SSR_IncludeComponent(uint32_t);
-	#ifdef __GNUC__
-		void __attribute__((naked)) __attribute__((noinline)) SSR_IncludeComponent(uint32_t) {
-			__asm("svc %0" : : "I" (SVC_INCLUDE_COMPONENT));
-			__asm("bx lr");
-		}
-    #else
-        #pragma inline = never
-  		__irq void SSR_IncludeComponent(uint32_t){
-			__asm("svc %0" : : "I" (SVC_INCLUDE_COMPONENT));
-			__asm("bx lr");
-        }
-	#endif
+// service numbers by name, from SSR_SERVICE_LIST: a stub traps with the
+// number its service is listed with (a stub without a list entry won't build)
+#define SSR_SERVICE_ID(Number, Name)		SSR_Id_##Name = (Number),
 
-	//--------------------------------------------------------------------------
-    //void __svc(0x02) SSR_ExcludeComponent(uint32_t);
-	#ifdef __GNUC__
-		void __attribute__((naked)) __attribute__((noinline)) SSR_ExcludeComponent(uint32_t) {
-			__asm("svc %0" : : "I" (SVC_EXCLUDE_COMPONENT));
-			__asm("bx lr");
-		}
-    #else
-        #pragma inline = never
-   		__irq void SSR_ExcludeComponent(uint32_t){
-			__asm("svc %0" : : "I" (SVC_EXCLUDE_COMPONENT));
-			__asm("bx lr");
-        }
+enum SSR_ServiceId : uint8_t { SSR_SERVICE_LIST(SSR_SERVICE_ID) };
 
-	#endif
+//------------------------------------------------------------------------------
+// SVC stubs (the host backend provides direct-call versions instead)
+#define SSR_STUB_LIST(X)												\
+	X(void,		IncludeComponent,	(uint32_t))							\
+	X(void,		ExcludeComponent,	(uint32_t))							\
+	X(uint32_t,	InstallCallback,	(uint32_t, uint32_t))				\
+	X(uint32_t,	GetCallback,		(uint32_t))							\
+	X(bool,		InstallTimeout,		(uint32_t, uint32_t))				\
+	X(uint32_t,	GetCallbackVector,	(uint32_t))							\
+	X(void,		ThrowMessage,		(uint32_t, uint32_t, uint32_t, uint32_t))	\
+	X(void,		ThrowException,		(uint32_t))							\
+	X(uint32_t,	Delay,				(uint32_t))							\
+	X(uint32_t,	MicroDelay,			(uint32_t))							\
+	X(uint32_t,	Batch,				(SSR_Request*, uint32_t))			\
+	X(uint32_t,	ArmTimeout,			(uint32_t, uint32_t))				\
+	X(bool,		CancelTimeout,		(uint32_t))							\
+	X(bool,		RescheduleTimeout,	(uint32_t, uint32_t))
 
-	//--------------------------------------------------------------------------
-    //uint32_t __svc(0x03) SSR_InstallCallback(uint32_t, uint32_t);
+// trapped unless SSR_DIRECT_TIME is defined
+#define SSR_TIME_STUB_LIST(X)											\
+	X(uint32_t,	GetSystemTime,		(void))								\
+	X(uint32_t,	GetKSCode,			(void))								\
+	X(uint32_t,	Microseconds,		(void))
+
+#ifndef SSR_HOST
+	// the result is left in r0 by the SVC handler (Frame[0])
 	#ifdef __GNUC__
+		#define SSR_SVC_STUB(Return, Name, Params)								\
+			Return __attribute__((naked)) __attribute__((noinline)) SSR_##Name Params {	\
+				__asm("svc %0" : : "I" (SSR_Id_##Name));						\
+				__asm("bx lr");													\
+			}
+
 		#pragma GCC diagnostic push
 		#pragma GCC diagnostic ignored "-Wreturn-type"
-		uint32_t __attribute__((naked)) __attribute__((noinline)) SSR_InstallCallback(uint32_t, uint32_t) {
-			__asm("svc %0" : : "I" (SVC_INSTALL_CALLBACK));
-			__asm("bx lr");
-		}
-    #else
-        #pragma diag_suppress=Pe940
-        #pragma inline = never        
-    	__irq uint32_t SSR_InstallCallback(uint32_t, uint32_t){
-			__asm("svc %0" : : "I" (SVC_INSTALL_CALLBACK));
-			__asm("bx lr");          
-        }
+	#else
+		#define SSR_SVC_STUB(Return, Name, Params)								\
+			_Pragma("inline = never")											\
+			__irq Return SSR_##Name Params {									\
+				__asm("svc %0" : : "I" (SSR_Id_##Name));						\
+				__asm("bx lr");													\
+			}
+
+		#pragma diag_suppress=Pe940
 	#endif
 
-    //--------------------------------------------------------------------------        
-    //void __svc(0x04) SSR_InstallCallback(uint32_t, uint32_t); NOT USED
+	extern "C" {
+		SSR_STUB_LIST(SSR_SVC_STUB)
+		#ifndef SSR_DIRECT_TIME
+			SSR_TIME_STUB_LIST(SSR_SVC_STUB)
+		#endif
+	}
 
-	//--------------------------------------------------------------------------
-	//uint32_t __svc(0x05) SSR_GetCallback(uint32_t);
 	#ifdef __GNUC__
-		#pragma GCC diagnostic push
-		#pragma GCC diagnostic ignored "-Wreturn-type"
-		uint32_t __attribute__((naked)) __attribute__((noinline)) SSR_GetCallback(uint32_t) {
-			__asm("svc %0" : : "I" (SVC_GET_CALLBACK));
-			__asm("bx lr");
-		}
-    #else
-        #pragma diag_suppress=Pe940
-        #pragma inline = never        
-		__irq uint32_t SSR_GetCallback(uint32_t){
-			__asm("svc %0" : : "I" (SVC_GET_CALLBACK));
-			__asm("bx lr");
-        }
-        #pragma diag_warning=Pe940
+		#pragma GCC diagnostic pop
+	#else
+		#pragma diag_warning=Pe940
 	#endif
+#endif
 
-	//--------------------------------------------------------------------------
-    //uint32_t __svc(0x06) SSR_GetSystemTime();
-	#ifdef __GNUC__
-		#pragma GCC diagnostic push
-		#pragma GCC diagnostic ignored "-Wreturn-type"
-		uint32_t __attribute__((naked)) __attribute__((noinline)) SSR_GetSystemTime(void) {
-			__asm("svc %0" : : "I" (SVC_GET_SYSTEM_TIME));
-			__asm("bx lr");
+//------------------------------------------------------------------------------
+// weak defaults of the kernel services, so the dispatch table links without
+// a kernel; the kernel's own definitions take their place. A service the
+// kernel does not provide traps (breakpoint, or HardFault without a debugger)
+// instead of failing silently.
+#if defined(__ICCARM__)
+	#define SSR_WEAK						__weak
+#else
+	#define SSR_WEAK						__attribute__((weak))
+#endif
+
+#define SSR_SERVICE_DEFAULT(Name)											\
+	SSR_WEAK uint32_t SSR_Service_##Name(uint32_t*){							\
+		__BKPT(0);																\
+		return(SSR_RESULT_INVALID);												\
+	}
+
+extern "C" {
+	SSR_SERVICE_DEFAULT(RelocateVectors)
+	SSR_SERVICE_DEFAULT(InstallCallback)
+	SSR_SERVICE_DEFAULT(GetCallback)
+	SSR_SERVICE_DEFAULT(GetCallbackVector)
+	SSR_SERVICE_DEFAULT(ThrowException)
+	SSR_SERVICE_DEFAULT(Delay)
+	SSR_SERVICE_DEFAULT(MicroDelay)
+}
+
+//------------------------------------------------------------------------------
+// constant dispatch table, generated from SSR_SERVICE_LIST
+#define SSR_SERVICE_NUMBER(Number, Name)	(uint32_t)(Number),
+#define SSR_SERVICE_ENTRY(Number, Name)		t.Handler[(Number)] = SSR_Service_##Name;
+
+static constexpr uint32_t SsrServiceNumbers[] = { SSR_SERVICE_LIST(SSR_SERVICE_NUMBER) };
+static constexpr uint32_t SsrServiceCount = sizeof(SsrServiceNumbers) / sizeof(SsrServiceNumbers[0]);
+
+static constexpr uint32_t SSR_GetServiceSlots(){
+	uint32_t result = 0;
+	for(uint32_t i=0; i<SsrServiceCount; i++){
+		if(SsrServiceNumbers[i] >= result){ result = SsrServiceNumbers[i] + 1;}
+	}
+	return(result);
+}
+
+static constexpr bool SSR_CheckServiceNumbers(){
+	for(uint32_t i=0; i<SsrServiceCount; i++){
+		for(uint32_t j=0; j<i; j++){
+			if(SsrServiceNumbers[i] == SsrServiceNumbers[j]){ return(false);}
 		}
-    #else
-        #pragma diag_suppress=Pe940
-        #pragma inline = never
-    	__irq uint32_t SSR_GetSystemTime(void) {
-			__asm("svc %0" : : "I" (SVC_GET_SYSTEM_TIME));
-			__asm("bx lr");
-        }
-        #pragma diag_warning=Pe940
+	}
+	return(true);
+}
+
+static constexpr uint32_t SSR_SERVICE_SLOTS = SSR_GetServiceSlots();
+static_assert(SSR_CheckServiceNumbers(), "duplicated service number in SSR_SERVICE_LIST");
+static_assert(SSR_SERVICE_SLOTS <= 256, "service numbers must fit the SVC immediate");
+
+static uint32_t SSR_Service_Invalid(uint32_t*){
+	return(SSR_RESULT_INVALID);
+}
+
+struct SSR_ServiceTable{
+	SSR_ServiceHandler Handler[SSR_SERVICE_SLOTS];
+};
+
+static constexpr SSR_ServiceTable SSR_BuildServiceTable(){
+	SSR_ServiceTable t = {};
+	for(uint32_t i=0; i<SSR_SERVICE_SLOTS; i++){ t.Handler[i] = SSR_Service_Invalid;}
+	SSR_SERVICE_LIST(SSR_SERVICE_ENTRY)
+	return(t);
+}
+
+static constexpr SSR_ServiceTable SsrServices = SSR_BuildServiceTable();
+
+#ifdef SSR_SERVICE_STATS
+	static SSR_ServiceStats SsrStats[SSR_SERVICE_SLOTS];
+#endif
+
+//------------------------------------------------------------------------------
+extern "C" {
+uint32_t SSR_Execute(uint8_t Service, uint32_t* Args){
+	if(Service >= SSR_SERVICE_SLOTS){ return(SSR_RESULT_INVALID);}
+
+	#ifdef SSR_SERVICE_STATS
+		uint32_t start = DWT->CYCCNT;
+		uint32_t result = SsrServices.Handler[Service](Args);
+		SsrStats[Service].Cycles += DWT->CYCCNT - start;
+		SsrStats[Service].Calls++;
+		return(result);
+	#else
+		return(SsrServices.Handler[Service](Args));
 	#endif
+}
 
-	//--------------------------------------------------------------------------
-    //bool __svc(0x07) SSR_InstallTimeout(uint32_t, uint32_t);
-	#ifdef __GNUC__
-		#pragma GCC diagnostic push
-		#pragma GCC diagnostic ignored "-Wreturn-type"
-		bool __attribute__((naked)) __attribute__((noinline)) SSR_InstallTimeout(uint32_t, uint32_t) {
-			__asm("svc %0" : : "I" (SVC_INSTALL_TIMEOUT));
-			__asm("bx lr");
-		}
-    #else
-        #pragma diag_suppress=Pe940
-        #pragma inline = never
-        __irq bool SSR_InstallTimeout(uint32_t, uint32_t){
-			__asm("svc %0" : : "I" (SVC_INSTALL_TIMEOUT));
-			__asm("bx lr");
-        }
-        #pragma diag_warning=Pe940
+//------------------------------------------------------------------------------
+void SSR_Dispatch(uint32_t* Frame){
+	// the immediate is the low byte of the "svc" opcode, just before the stacked PC
+	uint8_t service = ((uint8_t*)(uintptr_t)Frame[6])[-2];
+	#ifdef SSR_TRACE
+		// stacked PC and LR tell where the exception was thrown from
+		if(service == SVC_THROW_EXCEPTION){ TRC_Record(TRC_KIND_EXCEPTION, Frame[0], Frame[6], Frame[5]);}
 	#endif
+	Frame[0] = SSR_Execute(service, Frame);
+}
 
-	//--------------------------------------------------------------------------
-    //uint32_t __svc(0x08) SSR_GetKSCode();
-	#ifdef __GNUC__
-		#pragma GCC diagnostic push
-		#pragma GCC diagnostic ignored "-Wreturn-type"
-		uint32_t __attribute__((naked)) __attribute__((noinline)) SSR_GetKSCode(void) {
-			__asm("svc %0" : : "I" (SVC_GET_KS_CODE));
-			__asm("bx lr");
-		}
-    #else
-        #pragma diag_suppress=Pe940
-        #pragma inline = never
-    	__irq uint32_t SSR_GetKSCode(void){
-			__asm("svc %0" : : "I" (SVC_GET_KS_CODE));
-			__asm("bx lr");        
-        }
-        #pragma diag_warning=Pe940
+//------------------------------------------------------------------------------
+const SSR_ServiceStats* SSR_GetServiceStats(uint8_t Service){
+	#ifdef SSR_SERVICE_STATS
+		if(Service < SSR_SERVICE_SLOTS){ return(&SsrStats[Service]);}
+	#else
+		(void)Service;
 	#endif
+	return(NULL);
+}
 
-	//--------------------------------------------------------------------------
-	//uint32_t __svc(0x09) SSR_GetCallbackVector(uint32_t);
-	#ifdef __GNUC__
-		#pragma GCC diagnostic push
-		#pragma GCC diagnostic ignored "-Wreturn-type"
-		uint32_t __attribute__((naked)) __attribute__((noinline)) SSR_GetCallbackVector(uint32_t) {
-			__asm("svc %0" : : "I" (SVC_GET_CALLBACK_VECTOR));
-			__asm("bx lr");
+//------------------------------------------------------------------------------
+void SSR_ClearServiceStats(void){
+	#ifdef SSR_SERVICE_STATS
+		CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+		DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+		for(uint32_t i=0; i<SSR_SERVICE_SLOTS; i++){
+			SsrStats[i].Calls = 0;
+			SsrStats[i].Cycles = 0;
 		}
-    #else
-        #pragma diag_suppress=Pe940
-        #pragma inline = never
-        __irq uint32_t SSR_GetCallbackVector(uint32_t){
-			__asm("svc %0" : : "I" (SVC_GET_CALLBACK_VECTOR));
-			__asm("bx lr");
-        }
-        #pragma diag_warning=Pe940
 	#endif
+}
 
-	//--------------------------------------------------------------------------
-    //void __svc(0xFE) SSR_ThrowMessage(uint32_t, uint32_t, uint32_t, uint32_t);
-	#ifdef __GNUC__
-		void __attribute__((naked)) __attribute__((noinline)) SSR_ThrowMessage(uint32_t, uint32_t, uint32_t, uint32_t) {
-			__asm("svc %0" : : "I" (SVC_THROW_MESSAGE));
-			__asm("bx lr");
+//------------------------------------------------------------------------------
+uint32_t SSR_Service_Batch(uint32_t* Args){
+	return(SSR_ExecuteBatch((SSR_Request*)(uintptr_t)Args[0], Args[1]));
+}}
+
+//------------------------------------------------------------------------------
+// kernel side of the timeout services, running on the timing wheel
+static void SSR_TimeoutExpired(uint32_t Handle, void*, uint32_t Data){
+	SSR_NotifyTimeout(Data, Handle);
+}
+
+extern "C" SSR_WEAK void SSR_NotifyTimeout(uint32_t, uint32_t){}
+
+// the SSR_InstallTimeout() timer of each component, indexed by its registry
+// slot; the owner handle tells a reused slot from the component that armed it
+struct SSR_ComponentTimeout{
+	uint32_t Owner;
+	uint32_t Handle;
+};
+
+static SSR_ComponentTimeout SsrTimeouts[REG_CAPACITY];
+
+// the installed timeout entry of a registered component, or NULL
+static SSR_ComponentTimeout* SSR_GetComponentTimeout(uint32_t hReg){
+	uint32_t index = REG_GetIndex(hReg);
+	if(index >= REG_CAPACITY){ return(NULL);}
+	SSR_ComponentTimeout* t = &SsrTimeouts[index];
+	if(t->Owner != hReg){
+		TMW_Cancel(t->Handle);			// armed by a component released since
+		t->Owner = hReg;
+		t->Handle = TMW_INVALID;
+	}
+	return(t);
+}
+
+extern "C" {
+uint32_t SSR_Service_ArmTimeout(uint32_t* Args){
+	return(TMW_Arm(Args[1], SSR_TimeoutExpired, NULL, Args[0]));
+}
+
+uint32_t SSR_Service_InstallTimeout(uint32_t* Args){
+	SSR_ComponentTimeout* t = SSR_GetComponentTimeout(REG_Register(Args[0]));
+	if(t == NULL){ return(false);}
+	if(TMW_Reschedule(t->Handle, Args[1])){ return(true);}
+
+	t->Handle = SSR_Service_ArmTimeout(Args);
+	return(t->Handle != TMW_INVALID);
+}
+
+uint32_t SSR_Service_CancelTimeout(uint32_t* Args){
+	SSR_ComponentTimeout* t = SSR_GetComponentTimeout(REG_Find(Args[0]));
+	if(t == NULL){ return(TMW_Cancel(Args[0]));}
+
+	bool result = TMW_Cancel(t->Handle);
+	t->Handle = TMW_INVALID;
+	return(result);
+}
+
+uint32_t SSR_Service_RescheduleTimeout(uint32_t* Args){
+	return(TMW_Reschedule(Args[0], Args[1]));
+}
+
+//------------------------------------------------------------------------------
+// component registry (see DRV_REG); weak, so a kernel with its own component
+// list can serve them instead
+SSR_WEAK uint32_t SSR_Service_IncludeComponent(uint32_t* Args){
+	return(REG_Register(Args[0]));
+}
+
+// the timeout installed by the component goes with it
+SSR_WEAK uint32_t SSR_Service_ExcludeComponent(uint32_t* Args){
+	uint32_t handle = REG_Find(Args[0]);
+	SSR_ComponentTimeout* t = SSR_GetComponentTimeout(handle);
+	if(t != NULL){
+		TMW_Cancel(t->Handle);
+		t->Handle = TMW_INVALID;
+	}
+	return(REG_Unregister(handle));
+}
+
+SSR_WEAK uint32_t SSR_Service_FindComponent(uint32_t* Args){
+	return(REG_Find(Args[0]));
+}
+
+//------------------------------------------------------------------------------
+// thrown messages go to the signal lane, ahead of the regular notifications
+uint32_t SSR_Service_ThrowMessage(uint32_t* Args){
+	NMESSAGE message = {Args[0], Args[1], Args[2], Args[3]};
+	return(MSG_Post(MSG_LANE_SIGNAL, message));
+}}
+
+//------------------------------------------------------------------------------
+extern "C" {
+uint32_t SSR_ExecuteBatch(SSR_Request* List, uint32_t N){
+	uint32_t n = 0;
+	if(List == NULL){ return(0);}
+
+	for(; n<N; n++){
+		SSR_Request* r = &List[n];
+		if((r->Service == SVC_BATCH) || (r->Service > 0xFF)){
+			r->Result = SSR_RESULT_INVALID;
+		} else {
+			r->Result = SSR_Execute((uint8_t)r->Service, r->Args);
 		}
-    #else
-        #pragma inline = never
-        __irq void SSR_ThrowMessage(uint32_t, uint32_t, uint32_t, uint32_t){
-			__asm("svc %0" : : "I" (SVC_THROW_MESSAGE));
-			__asm("bx lr");
-        }
-	#endif
+	}
+	return(n);
+}}
 
-	//--------------------------------------------------------------------------
-    //void __svc(0xFF) SSR_ThrowException(uint32_t);
-	#ifdef __GNUC__
-		void __attribute__((naked)) __attribute__((noinline)) SSR_ThrowException(uint32_t){
-			__asm("svc %0" : : "I" (SVC_THROW_EXCEPTION));
-			__asm("bx lr");
+//------------------------------------------------------------------------------
+static SSR_TimeBlock SsrTime = {0, 0, 0};
+
+//------------------------------------------------------------------------------
+// consistent read of the published tick and the SysTick counter (seqlock)
+static uint32_t SSR_ReadMicroseconds(){
+	uint32_t seq, ms, val;
+	do{
+		seq = SsrTime.Sequence;
+		__DMB();
+		ms = SsrTime.Milliseconds;
+		val = SysTick->VAL;
+		// SysTick wrapped but the kernel did not publish the new tick yet
+		if(SCB->ICSR & SCB_ICSR_PENDSTSET_Msk){
+			val = SysTick->VAL;
+			ms++;
 		}
-    #else
-    	__irq void SSR_ThrowException(uint32_t){
-			__asm("svc %0" : : "I" (SVC_THROW_EXCEPTION));
-			__asm("bx lr");
-        }
-	#endif
+		__DMB();
+	} while((seq & 1) || (seq != SsrTime.Sequence));
+
+	uint32_t load = SysTick->LOAD + 1;
+	return((ms * 1000) + (((load - 1 - val) * 1000) / load));
+}
+
+//------------------------------------------------------------------------------
+extern "C" {
+// interrupts are masked so that no reader can preempt an odd Sequence and spin
+void SSR_PublishTime(uint32_t Milliseconds){
+	uint32_t primask = __get_PRIMASK();
+	__disable_irq();
+	SsrTime.Sequence++;
+	__DMB();
+	SsrTime.Milliseconds = Milliseconds;
+	__DMB();
+	SsrTime.Sequence++;
+	__set_PRIMASK(primask);
+}
+
+void SSR_PublishKSCode(uint32_t KSCode){
+	SsrTime.KSCode = KSCode;
+}
+
+const SSR_TimeBlock* SSR_GetTimeBlock(void){
+	return(&SsrTime);
+}
+
+//------------------------------------------------------------------------------
+// kernel side of the time services, reading the published time block; weak,
+// so a kernel keeping its own time can serve them instead
+SSR_WEAK uint32_t SSR_Service_GetSystemTime(uint32_t*){
+	return(SsrTime.Milliseconds);
+}
+
+SSR_WEAK uint32_t SSR_Service_GetKSCode(uint32_t*){
+	return(SsrTime.KSCode);
+}
+
+SSR_WEAK uint32_t SSR_Service_Microseconds(uint32_t*){
+	return(SSR_ReadMicroseconds());
+}
 
+#if defined(SSR_DIRECT_TIME) || defined(SSR_HOST)
 	//--------------------------------------------------------------------------
-	//uint32_t __svc(SVC_MICROSECONDS) SSR_Microseconds(uint32_t);
-	#ifdef __GNUC__
-		#pragma GCC diagnostic push
-		#pragma GCC diagnostic ignored "-Wreturn-type"
-		uint32_t __attribute__((naked)) __attribute__((noinline)) SSR_Microseconds(){
-			__asm("svc %0" : : "I" (SVC_MICROSECONDS));
-			__asm("bx lr");
-		}
-	#else
-		#pragma diag_suppress=Pe940
-		#pragma inline = never
-		__irq uint32_t SSR_Microseconds(){
-			__asm("svc %0" : : "I" (SVC_MICROSECONDS));
-			__asm("bx lr");
+	// direct-read versions of the time services (no SVC trap, see SSR_DIRECT_TIME)
+	uint32_t SSR_GetSystemTime(void){
+		return(SsrTime.Milliseconds);
+	}
+
+	uint32_t SSR_GetKSCode(void){
+		return(SsrTime.KSCode);
+	}
+
+	uint32_t SSR_Microseconds(void){
+		return(SSR_ReadMicroseconds());
+	}
+#endif
+}
+
+#ifdef SSR_FLASH_VECTORS
+#ifdef SSR_PROFILE_IRQ
+	#error "SSR_PROFILE_IRQ needs the RAM vector table (remove SSR_FLASH_VECTORS)"
+#endif
+
+//------------------------------------------------------------------------------
+// constant vector table in flash, generated from SSR_FLASH_HANDLERS
+typedef void (*SSR_IsrPointer)(void);
+
+extern "C" {
+	void Reset_Handler(void);
+	void NMI_Handler(void);
+	void HardFault_Handler(void);
+	void MemManage_Handler(void);
+	void BusFault_Handler(void);
+	void UsageFault_Handler(void);
+	void SVC_Handler(void);
+	void DebugMon_Handler(void);
+	void PendSV_Handler(void);
+	void SysTick_Handler(void);
+}
+
+static void SSR_UnhandledIrq(void){
+	while(true){}
+}
+
+struct SSR_FlashEntry{
+	int32_t Vector;
+	SSR_IsrPointer Isr;
+};
+
+#define SSR_FLASH_ENTRY(Nv, Isr)		{SSR_NVToIRQn(Nv) + 16, Isr},
+static constexpr SSR_FlashEntry SsrFlashEntries[] = { SSR_FLASH_HANDLERS(SSR_FLASH_ENTRY) };
+static constexpr uint32_t SsrFlashCount = sizeof(SsrFlashEntries) / sizeof(SsrFlashEntries[0]);
+
+static constexpr bool SSR_CheckFlashEntries(){
+	for(uint32_t i=0; i<SsrFlashCount; i++){
+		if((SsrFlashEntries[i].Vector < 16) || (SsrFlashEntries[i].Vector >= SSR_MAX_VECTORS)){ return(false);}
+	}
+	return(true);
+}
+
+// NV_IDs sharing an IRQ (i. e. NV_EXTINT5..9) must all name the same handler
+static constexpr bool SSR_CheckFlashDuplicates(){
+	for(uint32_t i=0; i<SsrFlashCount; i++){
+		for(uint32_t j=0; j<i; j++){
+			if((SsrFlashEntries[i].Vector == SsrFlashEntries[j].Vector) &&
+			   (SsrFlashEntries[i].Isr != SsrFlashEntries[j].Isr)){ return(false);}
 		}
-		#pragma diag_warning=Pe940
-	#endif
+	}
+	return(true);
+}
 
-		//--------------------------------------------------------------------------
-		//uint32_t __svc(SVC_DELAY) SSR_Delay(uint32_t);
-		#ifdef __GNUC__
-			#pragma GCC diagnostic push
-			#pragma GCC diagnostic ignored "-Wreturn-type"
-			uint32_t __attribute__((naked)) __attribute__((noinline)) SSR_Delay(uint32_t){
-				__asm("svc %0" : : "I" (SVC_DELAY));
-				__asm("bx lr");
-			}
-		#else
-			#pragma diag_suppress=Pe940
-			#pragma inline = never
-			__irq uint32_t SSR_Delay(uint32_t){
-				__asm("svc %0" : : "I" (SVC_DELAY));
-				__asm("bx lr");
-			}
-			#pragma diag_warning=Pe940
-		#endif
+static_assert(SSR_CheckFlashEntries(), "SSR_FLASH_HANDLERS names a NV_ID without vector on this device");
+static_assert(SSR_CheckFlashDuplicates(), "SSR_FLASH_HANDLERS assigns two handlers to the same vector");
+
+struct SSR_FlashTable{
+	SSR_IsrPointer Vector[SSR_MAX_VECTORS];
+};
+
+// entry 0 (initial SP) is only read at reset, from the boot table at 0x08000000
+static constexpr SSR_FlashTable SSR_BuildFlashTable(){
+	SSR_FlashTable t = {};
+	t.Vector[1] = Reset_Handler;
+	t.Vector[2] = NMI_Handler;
+	t.Vector[3] = HardFault_Handler;
+	t.Vector[4] = MemManage_Handler;
+	t.Vector[5] = BusFault_Handler;
+	t.Vector[6] = UsageFault_Handler;
+	t.Vector[11] = SVC_Handler;
+	t.Vector[12] = DebugMon_Handler;
+	t.Vector[14] = PendSV_Handler;
+	t.Vector[15] = SysTick_Handler;
+	for(uint32_t i=16; i<SSR_MAX_VECTORS; i++){ t.Vector[i] = SSR_UnhandledIrq;}
+	for(uint32_t i=0; i<SsrFlashCount; i++){ t.Vector[SsrFlashEntries[i].Vector] = SsrFlashEntries[i].Isr;}
+	return(t);
+}
 
-			//--------------------------------------------------------------------------
-			//uint32_t __svc(SVC_MICRODELAY) SSR_MicroDelay(uint32_t);
-			#ifdef __GNUC__
-				#pragma GCC diagnostic push
-				#pragma GCC diagnostic ignored "-Wreturn-type"
-				uint32_t __attribute__((naked)) __attribute__((noinline)) SSR_MicroDelay(uint32_t){
-					__asm("svc %0" : : "I" (SVC_MICRODELAY));
-					__asm("bx lr");
-				}
-			#else
-				#pragma diag_suppress=Pe940
-				#pragma inline = never
-				__irq uint32_t SSR_MicroDelay(uint32_t){
-					__asm("svc %0" : : "I" (SVC_MICRODELAY));
-					__asm("bx lr");
-				}
-				#pragma diag_warning=Pe940
-			#endif
+alignas(SSR_VECTORS_ALIGN) static constexpr SSR_FlashTable SsrFlashVectors = SSR_BuildFlashTable();
 
+//------------------------------------------------------------------------------
+extern "C" {
+void SSR_Relocate(int){
+	__DMB();
+	SCB->VTOR = (uint32_t)(uintptr_t)&SsrFlashVectors;
+	__DSB();
+}
 
+//------------------------------------------------------------------------------
+uint32_t* SSR_GetVectorTable(void){
+	return((uint32_t*)&SsrFlashVectors);
 }
 
+//------------------------------------------------------------------------------
+// the table is constant: handlers are bound at compile time, so a run-time
+// allocation only checks that SSR_FLASH_HANDLERS lists the same handler
+void SSR_Allocate(uint32_t IsrAddress, uint32_t VectorIndex){
+	if((VectorIndex >= SSR_MAX_VECTORS) || ((uint32_t)(uintptr_t)SsrFlashVectors.Vector[VectorIndex] != IsrAddress)){
+		__BKPT(0);		// missing from SSR_FLASH_HANDLERS (HardFault without debugger)
+	}
+}}
+
+#else
+//------------------------------------------------------------------------------
+// RAM vector table, reserved by the linker and aligned as VTOR requires
+#if defined(__ICCARM__)
+	#pragma data_alignment=SSR_VECTORS_ALIGN
+	static uint32_t SsrVectors[SSR_MAX_VECTORS] @ ".ram_vectors";
+#else
+	static uint32_t SsrVectors[SSR_MAX_VECTORS] __attribute__((section(".bss.ram_vectors"), aligned(SSR_VECTORS_ALIGN)));
+#endif
+
+static_assert(SSR_VECTORS_ALIGN >= (SSR_MAX_VECTORS * 4), "vector table alignment below its size");
+static_assert((SSR_VECTORS_ALIGN & (SSR_VECTORS_ALIGN - 1)) == 0, "vector table alignment must be a power of two");
+
 //------------------------------------------------------------------------------
 extern "C" {
 void SSR_Relocate(int nVectors){
-	#define HW32_REG(ADDRESS) (*((volatile unsigned long *)(ADDRESS)))
-	#define VTOR_NEW_ADDR 0x20000000
-	int i;
-	for (i=0; i<nVectors; i++){
-		HW32_REG((VTOR_NEW_ADDR + (i<<2))) = HW32_REG((i<<2));
+	uint32_t* source = (uint32_t*)(uintptr_t)SCB->VTOR;
+	if((nVectors <= 0) || (nVectors > SSR_MAX_VECTORS)){ nVectors = SSR_MAX_VECTORS;}
+	if(source == SsrVectors){ return;}
+
+	bool copied = false;
+	#ifdef SSR_RELOCATE_DMA
+		// polled, with the channel interrupts off: its handler can't take the TC flag
+		RCC->AHBENR |= RCC_AHBENR_DMA1EN;
+		if(DMA_Start(SSR_RELOCATE_DMA, SsrVectors, source, (uint16_t)nVectors, DMA_CCR_COPY_WORDS)){
+			DMA_WaitFreeChannel(SSR_RELOCATE_DMA);
+			copied = !DMA_CheckInterrupts(SSR_RELOCATE_DMA, DMA_ISR_TEIF1);
+			DMA_Stop(SSR_RELOCATE_DMA);
+		}
+	#endif
+	// CPU copy (also when the DMA channel is busy or the transfer failed)
+	if(!copied){
+		for(int i=0; i<nVectors; i++){ SsrVectors[i] = source[i];}
 	}
+
 	__DMB();
-	SCB->VTOR = VTOR_NEW_ADDR;
+	SCB->VTOR = (uint32_t)(uintptr_t)SsrVectors;
 	__DSB();
+}
+
+//------------------------------------------------------------------------------
+uint32_t* SSR_GetVectorTable(void){
+	return(SsrVectors);
 }}
 
 //------------------------------------------------------------------------------
 extern "C" {
 void SSR_Allocate(uint32_t IsrAddress, uint32_t VectorIndex){
-	#define HW32_REG(ADDRESS) (*((volatile unsigned long *)(ADDRESS)))
-	#define VTOR_NEW_ADDR 0x20000000
-	HW32_REG((VTOR_NEW_ADDR + (VectorIndex<<2))) = IsrAddress;
+	if(VectorIndex >= SSR_MAX_VECTORS){ return;}
+	#ifdef SSR_PROFILE_IRQ
+		IsrAddress = PRF_Wrap(IsrAddress, VectorIndex);
+	#endif
+	SsrVectors[VectorIndex] = IsrAddress;
 	__DMB();
 	__DSB();
 }}
 
+#endif
+
+//------------------------------------------------------------------------------
+// handler and context side by side, so the trampoline needs a single base address
+struct SSR_Binding{
+	SSR_ContextHandler Handler;
+	void* Context;
+};
+
+static SSR_Binding SsrBindings[SSR_MAX_VECTORS];
+
+//------------------------------------------------------------------------------
+extern "C" {
+void SSR_Trampoline(void){
+	const SSR_Binding* b = &SsrBindings[__get_IPSR()];
+	b->Handler(b->Context);
+}
+
+//------------------------------------------------------------------------------
+void SSR_AllocateContext(SSR_ContextHandler Handler, void* Context, uint32_t VectorIndex){
+	if((Handler == NULL) || (VectorIndex >= SSR_MAX_VECTORS)){ return;}
+
+	SsrBindings[VectorIndex].Handler = Handler;
+	SsrBindings[VectorIndex].Context = Context;
+	__DMB();
+	SSR_Allocate((uint32_t)(uintptr_t)SSR_Trampoline, VectorIndex);
+}
+
+//------------------------------------------------------------------------------
+void* SSR_GetContext(uint32_t VectorIndex){
+	if(VectorIndex >= SSR_MAX_VECTORS){ return(NULL);}
+	return(SsrBindings[VectorIndex].Context);
+}}
+
 //==============================================================================
 
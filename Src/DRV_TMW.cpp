@@ -0,0 +1,222 @@
+//==============================================================================
+#include "DRV_TMW.h"
+#include "stm32f1xx.h"
+
+//------------------------------------------------------------------------------
+struct TMW_Timer{
+	uint16_t Next;
+	uint16_t Prev;
+	uint16_t List;				// wheel list holding the timer (TMW_NONE when free)
+	uint16_t Generation;		// bumped on every release, invalidates old handles
+	uint32_t Expiry;
+	TMW_Callback Callback;
+	void* Context;
+	uint32_t Data;
+};
+
+static TMW_Timer TmwPool[__SYS_MAX_TIMERS];
+static uint16_t TmwLists[TMW_LISTS];
+static uint16_t TmwFree = TMW_NONE;
+static uint32_t TmwNow = 0;
+static uint32_t TmwArmed = 0;
+
+static_assert(__SYS_MAX_TIMERS < TMW_NONE, "timer pool too large for 16 bit indexes");
+
+//------------------------------------------------------------------------------
+static inline uint32_t TMW_Lock(){
+	uint32_t primask = __get_PRIMASK();
+	__disable_irq();
+	return(primask);
+}
+
+static inline void TMW_Unlock(uint32_t primask){
+	__set_PRIMASK(primask);
+}
+
+//------------------------------------------------------------------------------
+// handle = generation in the upper half, pool index in the lower half
+static TMW_Timer* TMW_Resolve(uint32_t Handle){
+	uint32_t index = Handle & 0xFFFF;
+	if(index >= __SYS_MAX_TIMERS){ return(NULL);}
+	TMW_Timer* t = &TmwPool[index];
+	if((t->List == TMW_NONE) || (t->Generation != (Handle >> 16))){ return(NULL);}
+	return(t);
+}
+
+//------------------------------------------------------------------------------
+// selects the list by the highest block the expiry shares with "now"
+static uint16_t TMW_Select(uint32_t expiry){
+	uint32_t level;
+	for(level=0; level<TMW_LEVELS; level++){
+		uint32_t shift = (level + 1) * TMW_SLOT_BITS;
+		if((expiry >> shift) == (TmwNow >> shift)){
+			return((uint16_t)(level * TMW_SLOTS + ((expiry >> (level * TMW_SLOT_BITS)) & TMW_SLOT_MASK)));
+		}
+	}
+	return(TMW_OVERFLOW);
+}
+
+//------------------------------------------------------------------------------
+static void TMW_Link(uint16_t index){
+	TMW_Timer* t = &TmwPool[index];
+	uint16_t list = TMW_Select(t->Expiry);
+	t->List = list;
+	t->Prev = TMW_NONE;
+	t->Next = TmwLists[list];
+	if(t->Next != TMW_NONE){ TmwPool[t->Next].Prev = index;}
+	TmwLists[list] = index;
+}
+
+//------------------------------------------------------------------------------
+static void TMW_Unlink(uint16_t index){
+	TMW_Timer* t = &TmwPool[index];
+	if(t->Prev != TMW_NONE){ TmwPool[t->Prev].Next = t->Next;}
+	else { TmwLists[t->List] = t->Next;}
+	if(t->Next != TMW_NONE){ TmwPool[t->Next].Prev = t->Prev;}
+}
+
+//------------------------------------------------------------------------------
+static void TMW_Release(uint16_t index){
+	TMW_Timer* t = &TmwPool[index];
+	t->List = TMW_NONE;
+	if(++t->Generation == 0){ t->Generation = 1;}
+	t->Next = TmwFree;
+	TmwFree = index;
+	TmwArmed--;
+}
+
+//------------------------------------------------------------------------------
+// moves every timer of a higher level slot to its place relative to "now"
+static void TMW_Cascade(uint16_t list){
+	uint16_t index = TmwLists[list];
+	TmwLists[list] = TMW_NONE;
+	while(index != TMW_NONE){
+		uint16_t next = TmwPool[index].Next;
+		TMW_Link(index);
+		index = next;
+	}
+}
+
+//------------------------------------------------------------------------------
+void TMW_Initialize(){
+	uint32_t primask = TMW_Lock();
+	for(uint32_t i=0; i<TMW_LISTS; i++){ TmwLists[i] = TMW_NONE;}
+	TmwFree = TMW_NONE;
+	for(uint32_t i=__SYS_MAX_TIMERS; i>0; i--){
+		TMW_Timer* t = &TmwPool[i - 1];
+		t->List = TMW_NONE;
+		if(++t->Generation == 0){ t->Generation = 1;}		// handles from before go stale
+		t->Next = TmwFree;
+		TmwFree = (uint16_t)(i - 1);
+	}
+	TmwNow = 0;
+	TmwArmed = 0;
+	TMW_Unlock(primask);
+}
+
+//------------------------------------------------------------------------------
+uint32_t TMW_Arm(uint32_t Ticks, TMW_Callback Callback, void* Context, uint32_t Data){
+	uint32_t result = TMW_INVALID;
+	if((Callback == NULL) || (Ticks > TMW_MAX_TICKS)){ return(result);}
+	if(Ticks == 0){ Ticks = 1;}
+
+	uint32_t primask = TMW_Lock();
+	uint16_t index = TmwFree;
+	if(index != TMW_NONE){
+		TMW_Timer* t = &TmwPool[index];
+		TmwFree = t->Next;
+		t->Expiry = TmwNow + Ticks;
+		t->Callback = Callback;
+		t->Context = Context;
+		t->Data = Data;
+		TMW_Link(index);
+		TmwArmed++;
+		result = ((uint32_t)t->Generation << 16) | index;
+	}
+	TMW_Unlock(primask);
+	return(result);
+}
+
+//------------------------------------------------------------------------------
+bool TMW_Cancel(uint32_t Handle){
+	bool result = false;
+	uint32_t primask = TMW_Lock();
+	if(TMW_Resolve(Handle) != NULL){
+		TMW_Unlink((uint16_t)Handle);
+		TMW_Release((uint16_t)Handle);
+		result = true;
+	}
+	TMW_Unlock(primask);
+	return(result);
+}
+
+//------------------------------------------------------------------------------
+bool TMW_Reschedule(uint32_t Handle, uint32_t Ticks){
+	bool result = false;
+	if(Ticks > TMW_MAX_TICKS){ return(result);}
+	if(Ticks == 0){ Ticks = 1;}
+
+	uint32_t primask = TMW_Lock();
+	TMW_Timer* t = TMW_Resolve(Handle);
+	if(t != NULL){
+		TMW_Unlink((uint16_t)Handle);
+		t->Expiry = TmwNow + Ticks;
+		TMW_Link((uint16_t)Handle);
+		result = true;
+	}
+	TMW_Unlock(primask);
+	return(result);
+}
+
+//------------------------------------------------------------------------------
+bool TMW_IsArmed(uint32_t Handle){
+	return(TMW_Resolve(Handle) != NULL);
+}
+
+//------------------------------------------------------------------------------
+void TMW_Tick(){
+	uint32_t primask = TMW_Lock();
+	uint32_t now = ++TmwNow;
+	if((now & TMW_SLOT_MASK) == 0){
+		if((now & ((1 << (2 * TMW_SLOT_BITS)) - 1)) == 0){
+			if((now & ((1 << (3 * TMW_SLOT_BITS)) - 1)) == 0){ TMW_Cascade(TMW_OVERFLOW);}
+			TMW_Cascade((uint16_t)(2 * TMW_SLOTS + ((now >> (2 * TMW_SLOT_BITS)) & TMW_SLOT_MASK)));
+		}
+		TMW_Cascade((uint16_t)(TMW_SLOTS + ((now >> TMW_SLOT_BITS) & TMW_SLOT_MASK)));
+	}
+	TMW_Unlock(primask);
+
+	// expired timers are released one at a time, so the callbacks run with
+	// interrupts enabled and may arm, cancel or reschedule any timer
+	uint16_t list = (uint16_t)(now & TMW_SLOT_MASK);
+	while(true){
+		primask = TMW_Lock();
+		uint16_t index = TmwLists[list];
+		if(index == TMW_NONE){
+			TMW_Unlock(primask);
+			break;
+		}
+		TMW_Timer* t = &TmwPool[index];
+		uint32_t handle = ((uint32_t)t->Generation << 16) | index;
+		TMW_Callback callback = t->Callback;
+		void* context = t->Context;
+		uint32_t data = t->Data;
+		TMW_Unlink(index);
+		TMW_Release(index);
+		TMW_Unlock(primask);
+
+		callback(handle, context, data);
+	}
+}
+
+//------------------------------------------------------------------------------
+uint32_t TMW_GetTime(){
+	return(TmwNow);
+}
+
+//------------------------------------------------------------------------------
+uint32_t TMW_GetArmed(){
+	return(TmwArmed);
+}
+
+//==============================================================================
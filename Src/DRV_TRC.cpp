@@ -0,0 +1,57 @@
+//==============================================================================
+#include "DRV_TRC.h"
+#include "DRV_CPU.h"
+#include "DRV_SSR.h"
+
+static_assert((TRC_DEPTH >= 2) && ((TRC_DEPTH & (TRC_DEPTH - 1)) == 0), "TRC_DEPTH must be a power of two");
+
+//------------------------------------------------------------------------------
+static TRC_Block TrcBlock CPU_NOINIT;
+
+//------------------------------------------------------------------------------
+uint32_t TRC_Initialize(bool Preserve){
+	CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+	DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+	bool valid = (TrcBlock.Magic == TRC_MAGIC) && (TrcBlock.Depth == TRC_DEPTH);
+	if(!Preserve || !valid){
+		TrcBlock.Head = 0;
+		for(uint32_t i=0; i<TRC_DEPTH; i++){ TrcBlock.Records[i].Info = 0;}
+	}
+	TrcBlock.Clock = SystemCoreClock;
+	TrcBlock.Depth = TRC_DEPTH;
+	TrcBlock.Magic = TRC_MAGIC;
+	return(TRC_Count());
+}
+
+//------------------------------------------------------------------------------
+// the kernel side of SVC_GET_SYSTEM_TIME is called directly: the stub would
+// trap again from the SVC handler, where the exceptions are recorded
+void TRC_Record(uint8_t Kind, uint32_t Code, uint32_t Data1, uint32_t Data2){
+	uint32_t ms = SSR_Service_GetSystemTime(NULL);
+
+	uint32_t primask = __get_PRIMASK();
+	__disable_irq();
+	uint32_t head = TrcBlock.Head;
+	TRC_Entry* r = &TrcBlock.Records[head & (TRC_DEPTH - 1)];
+	r->Cycles = DWT->CYCCNT;
+	r->Milliseconds = ms;
+	r->Info = ((uint32_t)Kind << 24) | (head & 0x00FFFFFF);
+	r->Code = Code;
+	r->Data1 = Data1;
+	r->Data2 = Data2;
+	TrcBlock.Head = head + 1;
+	__set_PRIMASK(primask);
+}
+
+//------------------------------------------------------------------------------
+const TRC_Block* TRC_GetBlock(){
+	return(&TrcBlock);
+}
+
+//------------------------------------------------------------------------------
+uint32_t TRC_Count(){
+	return((TrcBlock.Head < TRC_DEPTH)? TrcBlock.Head : TRC_DEPTH);
+}
+
+//==============================================================================
@@ -0,0 +1,121 @@
+//==============================================================================
+#include "DRV_WAV.h"
+#include "DRV_CPU.h"
+#include "DRV_DMA.h"
+#include "DRV_SSR.h"
+
+//------------------------------------------------------------------------------
+static WAV_Callback WavCallback = NULL;
+static void* WavContext = NULL;
+
+//------------------------------------------------------------------------------
+// clock of the timer, from the bus it sits on
+#ifdef WAV_TIMER_APB2
+	#define WAV_TIMER_FREQUENCY()		CPU_GetTimerFrequencyAPB2()
+#else
+	#define WAV_TIMER_FREQUENCY()		CPU_GetTimerFrequencyAPB1()
+#endif
+
+//------------------------------------------------------------------------------
+void WAV_Initialize(){
+#ifdef WAV_TIMER_APB2
+	RCC->APB2ENR |= WAV_TIMER_CLOCK;
+#else
+	RCC->APB1ENR |= WAV_TIMER_CLOCK;
+#endif
+	RCC->AHBENR |= RCC_AHBENR_DMA1EN;
+
+	WAV_TIMER->CR1 = 0;
+	WAV_TIMER->DIER = 0;
+	DMA_Stop(WAV_DMA);
+
+	SSR_Allocate((uint32_t)WAV_Handler, SSR_VECTOR(WAV_DMA_IRQn));
+	CPU_SetPriorityIRQn(WAV_DMA_IRQn, WAV_PRIORITY);
+	NVIC_EnableIRQ(WAV_DMA_IRQn);
+}
+
+//------------------------------------------------------------------------------
+bool WAV_Start(GPIO_TypeDef* Port, const uint32_t* Buffer, uint16_t Count, uint32_t Frequency,
+		bool Circular, WAV_Callback Callback, void* Context){
+	if((Port == NULL) || (Frequency == 0) || WAV_IsBusy()){ return(false);}
+
+	uint32_t ticks = WAV_TIMER_FREQUENCY() / Frequency;
+	if(ticks < 2){ ticks = 2;}
+	uint32_t prescaler = (ticks - 1) >> 16;
+
+	WavCallback = Callback;
+	WavContext = Context;
+
+	WAV_TIMER->CR1 = 0;
+	WAV_TIMER->DIER = 0;
+	WAV_TIMER->PSC = prescaler;
+	WAV_TIMER->ARR = (ticks / (prescaler + 1)) - 1;
+	WAV_TIMER->EGR = TIM_EGR_UG;			// loads PSC/ARR (no DMA request yet)
+	WAV_TIMER->SR = 0;
+
+	uint32_t config = DMA_CCR_STREAM_WORDS | DMA_CCR_PL_1;
+	if(Circular){ config |= DMA_CCR_CIRC | DMA_CCR_HTIE;}
+	if(!DMA_Start(WAV_DMA, &Port->BSRR, Buffer, Count, config)){ return(false);}
+
+	WAV_TIMER->DIER = TIM_DIER_UDE;
+	WAV_TIMER->CR1 = TIM_CR1_ARPE | TIM_CR1_CEN;
+	return(true);
+}
+
+//------------------------------------------------------------------------------
+void WAV_Stop(){
+	WAV_TIMER->CR1 = 0;
+	WAV_TIMER->DIER = 0;
+	DMA_Stop(WAV_DMA);
+}
+
+//------------------------------------------------------------------------------
+bool WAV_IsBusy(){
+	return(WAV_TIMER->CR1 & TIM_CR1_CEN);
+}
+
+//------------------------------------------------------------------------------
+extern "C" void WAV_Handler(void){
+	uint32_t event = 0;
+	if(DMA_CheckInterrupts(WAV_DMA, DMA_ISR_TEIF1)){ event |= WAV_EVENT_ERROR;}
+	if(DMA_CheckInterrupts(WAV_DMA, DMA_ISR_HTIF1)){ event |= WAV_EVENT_HALF;}
+	if(DMA_CheckInterrupts(WAV_DMA, DMA_ISR_TCIF1)){ event |= WAV_EVENT_DONE;}
+	DMA_ClearInterrupts(WAV_DMA, DMA_IFCR_ALL);
+
+	// one-shot (or failed) output: the last word is out, stop the pacing timer
+	if((event & WAV_EVENT_ERROR) || ((event & WAV_EVENT_DONE) && !(WAV_DMA->CCR & DMA_CCR_CIRC))){
+		WAV_Stop();
+	}
+	if((event != 0) && (WavCallback != NULL)){ WavCallback(event, WavContext);}
+}
+
+//------------------------------------------------------------------------------
+uint32_t WAV_CompileBits(uint32_t* Buffer, uint32_t Max, uint16_t PinMask,
+		const uint8_t* Data, uint32_t Bits, const WAV_BitCode& Code){
+	uint32_t result = Bits * Code.Slots;
+	if((Code.Slots == 0) || (result > Max)){ return(0);}
+
+	uint32_t high = PinMask;
+	uint32_t low = (uint32_t)PinMask << 16;
+	for(uint32_t i=0; i<Bits; i++){
+		uint32_t width = ((Data[i >> 3] << (i & 7)) & 0x80)? Code.One : Code.Zero;
+		for(uint32_t s=0; s<Code.Slots; s++){ *Buffer++ = (s < width)? high : low;}
+	}
+	return(result);
+}
+
+//------------------------------------------------------------------------------
+uint32_t WAV_CompileBus(uint32_t* Buffer, uint32_t Max, uint16_t BusMask, uint32_t Shift,
+		uint16_t StrobeMask, const uint16_t* Values, uint32_t N){
+	uint32_t result = StrobeMask? (N * 2) : N;
+	if(result > Max){ return(0);}
+
+	for(uint32_t i=0; i<N; i++){
+		uint32_t v = ((uint32_t)Values[i] << Shift) & BusMask;
+		*Buffer++ = v | ((BusMask & ~v) << 16) | ((uint32_t)StrobeMask << 16);
+		if(StrobeMask){ *Buffer++ = StrobeMask;}
+	}
+	return(result);
+}
+
+//==============================================================================
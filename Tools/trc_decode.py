@@ -0,0 +1,93 @@
+#!/usr/bin/env python3
+#===============================================================================
+# @file trc_decode.py
+# @brief Decoder of the DRV_TRC trace block (host side).
+#
+# Reads a raw dump of the TRC_Block (i. e. from gdb:
+#   set $b = TRC_GetBlock()
+#   dump binary memory trc.bin $b $b+1
+# or any copy sent over a serial link) and
+# prints the records oldest first, mapping the NX_* codes of SysExceptions.h
+# (and optionally the message ids of other headers) to their names.
+#
+# @author J. Nilo Rodrigues - nilo@pobox.com
+# BSD 3-Clause license (see the driver sources).
+#===============================================================================
+import argparse
+import os
+import re
+import struct
+import sys
+
+TRC_MAGIC = 0x54524331
+KINDS = {0x01: "EXCEPTION", 0x02: "MESSAGE"}
+DEFINE = re.compile(r"^\s*#\s*define\s+(\w+)\s+\(\s*\(\s*uint32_t\s*\)\s*(0x[0-9A-Fa-f]+|\d+)\s*\)")
+DEFINE_PLAIN = re.compile(r"^\s*#\s*define\s+(\w+)\s+(0x[0-9A-Fa-f]+|\d+)\b")
+
+
+#-------------------------------------------------------------------------------
+def load_names(path, prefix):
+    names = {}
+    with open(path) as f:
+        for line in f:
+            m = DEFINE.match(line) or DEFINE_PLAIN.match(line)
+            if m and m.group(1).startswith(prefix):
+                names.setdefault(int(m.group(2), 0), m.group(1))
+    return names
+
+
+#-------------------------------------------------------------------------------
+def decode(data, exceptions, messages, out):
+    if len(data) < 16:
+        raise ValueError("dump too short for a trace block header")
+    magic, head, clock, depth = struct.unpack_from("<4I", data, 0)
+    if magic != TRC_MAGIC:
+        raise ValueError("bad magic 0x%08X (expected 0x%08X)" % (magic, TRC_MAGIC))
+    if len(data) < 16 + depth * 24:
+        raise ValueError("dump too short for %d records" % depth)
+
+    count = min(head, depth)
+    out.write("records: %d of %d written, clock %d Hz\n" % (count, head, clock))
+    for n in range(head - count, head):
+        cycles, ms, info, code, d1, d2 = struct.unpack_from("<6I", data, 16 + (n % depth) * 24)
+        kind = info >> 24
+        if kind == 0x01:
+            name = exceptions.get(code, "0x%08X" % code)
+        elif kind == 0x02:
+            name = messages.get(code, "0x%08X" % code)
+        else:
+            name = "0x%08X" % code
+        us = (cycles * 1000000 // clock) if clock else 0
+        out.write("#%-6d %10d ms  cyc %10d (%8d us)  %-9s %-36s 0x%08X 0x%08X\n"
+                  % (info & 0xFFFFFF, ms, cycles, us, KINDS.get(kind, "KIND_%02X" % kind), name, d1, d2))
+
+
+#-------------------------------------------------------------------------------
+def main():
+    here = os.path.dirname(os.path.abspath(__file__))
+    parser = argparse.ArgumentParser(description="Decode a DRV_TRC trace block dump.")
+    parser.add_argument("dump", help="raw binary dump of the TRC_Block")
+    parser.add_argument("--exceptions", default=os.path.join(here, "..", "Inc", "SysExceptions.h"),
+                        help="header with the NX_* exception codes")
+    parser.add_argument("--messages", action="append", default=[],
+                        help="header(s) with the message ids (may be repeated)")
+    parser.add_argument("--message-prefix", default="NM_", help="prefix of the message id defines")
+    args = parser.parse_args()
+
+    exceptions = load_names(args.exceptions, "NX_")
+    messages = {}
+    for path in args.messages:
+        messages.update(load_names(path, args.message_prefix))
+
+    with open(args.dump, "rb") as f:
+        data = f.read()
+    try:
+        decode(data, exceptions, messages, sys.stdout)
+    except ValueError as e:
+        sys.stderr.write("trc_decode: %s\n" % e)
+        return 1
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())